@@ -42,7 +42,7 @@ namespace Core::Maths
         struct { float x; float y; float z; };
         struct { float r; float g; float b; };
         struct { float c; float l; float q; };
-        struct { float u; float v; float q; };
+        struct { float u; float v; };
 
         inline float squaredMagnitude() const;
 
@@ -379,9 +379,9 @@ namespace Core::Maths
 	}
 
 	template<typename T>
-	vec3& operator/=(const vec3& lhs, const T& scale)
+	vec3& operator/=(vec3& lhs, const T& scale)
 	{
-		if (scale != 0.f)
+		if (scale == 0.f)
 		    return lhs;
 
 		lhs = lhs / scale;
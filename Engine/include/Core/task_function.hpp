@@ -0,0 +1,154 @@
+#pragma once
+
+#include <new>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+
+// Bytes stored in place: a lambda capturing a few shared_ptr and a path string fits
+#define TASK_FUNCTION_BUFFER_SIZE 112
+
+// Move-only void() callable of the thread pool and the GL requests. The callable is stored in place when it fits (no
+// allocation), on the heap otherwise. Moved through the queues, never copied
+class TaskFunction
+{
+private:
+	struct Operations
+	{
+		void (*invoke)(void* storage);
+		void (*move)(void* from, void* to);	// Construct in to, then destroy from
+		void (*destroy)(void* storage);
+	};
+
+	template <typename Callable>
+	static constexpr bool isInPlace = sizeof(Callable) <= TASK_FUNCTION_BUFFER_SIZE && alignof(Callable) <= alignof(std::max_align_t)
+		&& std::is_nothrow_move_constructible_v<Callable>;
+
+	template <typename Callable>
+	struct InPlace
+	{
+		static Callable* get(void* storage) { return std::launder(reinterpret_cast<Callable*>(storage)); }
+
+		static void invoke(void* storage) { (*get(storage))(); }
+
+		static void move(void* from, void* to)
+		{
+			new (to) Callable(std::move(*get(from)));
+			get(from)->~Callable();
+		}
+
+		static void destroy(void* storage) { get(storage)->~Callable(); }
+
+		static constexpr Operations operations = { &invoke, &move, &destroy };
+	};
+
+	template <typename Callable>
+	struct OnHeap
+	{
+		static Callable*& get(void* storage) { return *std::launder(reinterpret_cast<Callable**>(storage)); }
+
+		static void invoke(void* storage) { (*get(storage))(); }
+
+		static void move(void* from, void* to)
+		{
+			new (to) Callable*(get(from));
+		}
+
+		static void destroy(void* storage) { delete get(storage); }
+
+		static constexpr Operations operations = { &invoke, &move, &destroy };
+	};
+
+	alignas(std::max_align_t) unsigned char storage[TASK_FUNCTION_BUFFER_SIZE];
+	const Operations* operations = nullptr;
+
+	// Callables too big for the buffer since the start
+	static inline std::atomic<size_t> heapCount{ 0 };
+
+	void reset()
+	{
+		if (!operations)
+			return;
+
+		operations->destroy(storage);
+		operations = nullptr;
+	}
+
+	void moveFrom(TaskFunction& other)
+	{
+		if (!other.operations)
+			return;
+
+		other.operations->move(other.storage, storage);
+		operations = other.operations;
+		other.operations = nullptr;
+	}
+
+public:
+	TaskFunction() = default;
+	TaskFunction(std::nullptr_t) {}
+
+	template <typename Function, typename Callable = std::decay_t<Function>,
+		typename = std::enable_if_t<!std::is_same_v<Callable, TaskFunction> && std::is_invocable_v<Callable&>>>
+	TaskFunction(Function&& function)
+	{
+		if constexpr (isInPlace<Callable>)
+		{
+			new (storage) Callable(std::forward<Function>(function));
+			operations = &InPlace<Callable>::operations;
+		}
+		else
+		{
+			new (storage) Callable*(new Callable(std::forward<Function>(function)));
+			operations = &OnHeap<Callable>::operations;
+
+			heapCount.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	TaskFunction(TaskFunction&& other) noexcept
+	{
+		moveFrom(other);
+	}
+
+	TaskFunction& operator=(TaskFunction&& other) noexcept
+	{
+		if (this != &other)
+		{
+			reset();
+			moveFrom(other);
+		}
+
+		return *this;
+	}
+
+	TaskFunction& operator=(std::nullptr_t)
+	{
+		reset();
+		return *this;
+	}
+
+	TaskFunction(const TaskFunction&) = delete;
+	TaskFunction& operator=(const TaskFunction&) = delete;
+
+	~TaskFunction()
+	{
+		reset();
+	}
+
+	void operator()()
+	{
+		operations->invoke(storage);
+	}
+
+	explicit operator bool() const
+	{
+		return operations != nullptr;
+	}
+
+	static size_t getHeapCount()
+	{
+		return heapCount.load(std::memory_order_relaxed);
+	}
+};
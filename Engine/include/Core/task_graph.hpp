@@ -0,0 +1,150 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+#include "thread_pool.hpp"
+
+namespace Core
+{
+	class TaskGroup;
+
+	// Node of a TaskGroup: a function run once its predecessors ended (on the pool when isMulti, in the lane of the thread that
+	// added it, else on the thread that made it ready), or an event ended by end() (GL upload, ...). Its successors are its continuations
+	class Task : public std::enable_shared_from_this<Task>
+	{
+		friend TaskGroup;
+
+	public:
+		using Function = TaskFunction;
+
+	private:
+		std::string m_name;
+		Function m_function;
+		bool m_isMulti = true;
+		bool m_isEvent = false;
+		TaskPriority m_priority = TaskPriority::NORMAL;	// Of the thread adding it
+
+		std::shared_ptr<TaskGroup> m_group = nullptr;
+		size_t id = 0;
+
+		// Predecessors not ended, + 1 until submitted
+		std::atomic<int> pendingCount{ 1 };
+		std::atomic_flag isSubmitted = ATOMIC_FLAG_INIT;
+
+		std::vector<std::shared_ptr<Task>> successors;
+		std::vector<size_t> predecessors;
+		bool isEnded = false;
+		bool isReady = false;		// Event only
+		bool isEndRequested = false;	// Event only
+		std::atomic_flag lock = ATOMIC_FLAG_INIT;
+
+		// Task running on this thread, its tasks submitted without predecessor are spawned by it
+		static thread_local Task* current;
+
+		void arrive();
+		void execute();
+		void finish();
+
+	public:
+		Task(const std::shared_ptr<TaskGroup>& group, const std::string& name, Function function, bool isMulti, bool isEvent);
+
+		Task(const Task&) = delete;
+		Task& operator=(const Task&) = delete;
+
+		// Before submit, start once the predecessor ended (nothing to wait if it already did)
+		void after(const std::shared_ptr<Task>& predecessor);
+
+		// Once added and its predecessors set, every task of the group must be submitted
+		void submit();
+
+		// Continuation in the same group, submitted right away
+		std::shared_ptr<Task> then(const std::string& name, Function function, bool isMulti = true);
+
+		// Event only, ended once its predecessors ended too
+		void end();
+
+		const std::string& getName() const;
+	};
+
+	// Tasks with dependencies, done once every task added ended. Tasks can be added by the running ones until then
+	class TaskGroup : public std::enable_shared_from_this<TaskGroup>
+	{
+		friend Task;
+
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		// Part of the critical path, in seconds
+		struct Step
+		{
+			std::string name;
+			float waitTime = 0.f;	// Ready but not started (pool queue, GL requests)
+			float runTime = 0.f;
+		};
+
+		using DoneCallback = std::function<void(TaskGroup&)>;
+
+	private:
+		struct Record
+		{
+			std::string name;
+			std::vector<size_t> predecessors;
+			long long spawner = -1;
+			Clock::time_point submitTime;
+			Clock::time_point readyTime;
+			Clock::time_point startTime;
+			Clock::time_point endTime;
+		};
+
+		std::string m_name;
+		DoneCallback m_onDone;
+
+		Clock::time_point startTime;
+		Clock::time_point endTime;
+
+		std::atomic<int> pendingCount{ 0 };
+		std::atomic<bool> isCompleted{ false };
+		std::atomic_flag completedOnce = ATOMIC_FLAG_INIT;
+
+		std::vector<Record> records;
+		std::atomic_flag lockRecords = ATOMIC_FLAG_INIT;
+
+		std::shared_ptr<Task> add(const std::string& name, Task::Function function, bool isMulti, bool isEvent);
+		Record& getRecord(size_t id);
+		void endTask();
+
+	public:
+		TaskGroup(const std::string& name, const DoneCallback& onDone = nullptr);
+
+		TaskGroup(const TaskGroup&) = delete;
+		TaskGroup& operator=(const TaskGroup&) = delete;
+
+		// Not started until submitted, set its predecessors first
+		std::shared_ptr<Task> add(const std::string& name, Task::Function function, bool isMulti = true);
+
+		// Ended by Task::end instead of a function
+		std::shared_ptr<Task> addEvent(const std::string& name);
+
+		// add then submit
+		std::shared_ptr<Task> run(const std::string& name, Task::Function function, bool isMulti = true);
+
+		bool isDone() const;
+
+		// A pool worker runs other tasks meanwhile, never wait on the thread that ends the events
+		void wait() const;
+
+		const std::string& getName() const;
+		size_t getTasksCount();
+
+		// Seconds between the group creation and its last task end (0 while pending)
+		float getTime() const;
+
+		// Chain of tasks that ended last: from the last one, its predecessor that ended last (or the task that spawned it)
+		std::vector<Step> getCriticalPath();
+	};
+}
@@ -2,13 +2,37 @@
 
 #include <thread>
 #include <vector>
+#include <memory>
 #include <atomic>
-#include <queue>
-#include <functional>// par la aussi
+#include <deque>
+#include <array>
+#include <mutex>
+#include <chrono>
+#include <functional>
+#include <condition_variable>
 #include <iostream>
 
 #include "singleton.hpp"
+#include "work_deque.hpp"
+#include "task_function.hpp"
 
+#define POOL_SPIN_COUNT 64		// Searches for a task with a CPU pause, before yielding
+#define POOL_YIELD_COUNT 16		// Searches for a task with a yield, before parking
+#define POOL_TASKS_BATCH 64		// Task slots allocated at once, and moved at once between a worker and the shared free slots
+#define POOL_MAX_FREE_SLOTS 4096	// Shared free slots kept after a burst of tasks, the others are deleted
+
+// Lanes of the pool, a task of a lane only starts when the lanes before are empty
+enum class TaskPriority
+{
+	CRITICAL,	// Needed to interact (what is in front of the camera)
+	NORMAL,
+	BACKGROUND,	// Never needed by a loading (cache baking), leaves a worker to the other lanes
+	COUNT
+};
+
+// Work-stealing pool: each worker runs the tasks of its own deque first (the tasks added from a task go there), then the
+// tasks added by the threads out of the pool (injection queue), then steals the oldest tasks of a random worker, lane by lane.
+// A worker without task spins a little, then yields, then parks until addTask wakes it
 class ThreadPool final : public Singleton<ThreadPool>
 {
 	friend Singleton<ThreadPool>;
@@ -16,43 +40,126 @@ public:
 	ThreadPool();
 	~ThreadPool();
 
-	static void init();
+	// One worker per hardware thread by default
+	static void init(unsigned int threadsCount = 0);
 	static void end();
 
-	template <typename Task>
-	static void addTask(Task task)
+	// Same priority as the task adding it (NORMAL out of the pool, or the one of the PriorityScope)
+	static void addTask(TaskFunction task);
+	static void addTask(TaskFunction task, TaskPriority priority);
+
+	static TaskPriority getCurrentPriority();
+
+	// Priority of the tasks added by this thread until the scope ends
+	class PriorityScope
 	{
-		ThreadPool* TP = instance();
+	private:
+		TaskPriority previous;
 
-		// Lock free - Avoid multiple call at the same time
-		while (TP->taskManager.test_and_set());
+	public:
+		PriorityScope(TaskPriority priority);
+		~PriorityScope();
+	};
 
-		TP->count.fetch_add(1);
-		TP->tasks.push(std::function<void()>(task));
+	// Run func(0) ... func(count - 1) on the workers, the calling thread helps and returns when all are done
+	static void parallelFor(size_t count, const std::function<void(size_t)>& func);
 
-		// Notify at least one thread waiting 
-		// taskManager.notify_one();
-		TP->taskManager.clear();
-	}
+	// A worker runs other tasks until isDone, the other threads yield
+	static void waitUntil(const std::function<bool()>& isDone);
 
 	static bool running();
 	static bool allowKill();
+	static unsigned int getThreadsCount();
 
-	//static ThreadPool* getInstance() { return instance(); } rayane est aussi passe par la
+	struct Stats
+	{
+		size_t wakeupsCount = 0;
+		float averageWakeLatency = 0.f;	// Microseconds between addTask and the parked worker running again
+		float maxWakeLatency = 0.f;
+		float spinningTime = 0.f;		// Seconds of the workers searching for a task without finding one (CPU used while idle)
+		float parkedTime = 0.f;			// Seconds of the workers parked (no CPU used)
+
+		std::array<size_t, (size_t)TaskPriority::COUNT> tasksCount = {};	// Tasks run, per lane
+		size_t slotsCount = 0;			// Task slots alive, reused once their task ran
+	};
+
+	static Stats getStats();
 
 private:
-	std::vector<std::thread> threads;
-	std::queue<std::function<void()>> tasks;
+	struct Worker
+	{
+		std::array<WorkDeque<TaskFunction>, (size_t)TaskPriority::COUNT> deques;
+		uint32_t seed = 0;		// Victims picking
 
-	std::atomic_flag taskManager = ATOMIC_FLAG_INIT;
+		// Slots of the tasks it ran, taken by the tasks it adds (worker thread only)
+		std::vector<TaskFunction*> freeSlots;
+	};
+
+	std::vector<std::thread> threads;
+	std::vector<std::unique_ptr<Worker>> workers;
+
+	// Tasks added by the threads out of the pool, taken from the first not taken (cleared once all are)
+	std::array<std::vector<TaskFunction*>, (size_t)TaskPriority::COUNT> injected;
+	std::array<size_t, (size_t)TaskPriority::COUNT> injectedFirst = {};
+	std::atomic_flag lockInjected = ATOMIC_FLAG_INIT;
+
+	// The queues hold task slots, allocated by batch and reused: adding a task allocates nothing once they are warm
+	std::vector<TaskFunction*> freeSlots;	// Slots given back by the workers, and taken by the threads out of the pool
+	std::atomic_flag lockSlots = ATOMIC_FLAG_INIT;
+	std::atomic<size_t> slotsCount{ 0 };
+
+	// Index of the worker running on this thread, -1 out of the pool
+	static thread_local int workerIndex;
+	static thread_local TaskPriority currentPriority;
+
+	// Workers running a background task, one worker at least is left to the other lanes. None is kept with a single
+	// worker (0), the background tasks then only run when the other lanes are empty
+	std::atomic<int> backgroundCount{ 0 };
+	int maxBackgroundCount = 0;
+
+	std::array<std::atomic<size_t>, (size_t)TaskPriority::COUNT> tasksCount = {};
+
+	// Parked workers, each wakeup is taken by one of them with the time addTask gave it
+	std::mutex parkMutex;
+	std::condition_variable parkCondition;
+	std::atomic<int> parkedCount{ 0 };
+	int wakeupsCount = 0;
+	std::deque<std::chrono::steady_clock::time_point> wakeTimes;
+
+	std::atomic<size_t> totalWakeups{ 0 };
+	std::atomic<long long> wakeLatency{ 0 };		// Nanoseconds
+	std::atomic<long long> maxWakeLatency{ 0 };
+	std::atomic<long long> spinningTime{ 0 };
+	std::atomic<long long> parkedTime{ 0 };
 
 	unsigned int maxNumThreads = 0;
 
-	void threadRoutine();
+	TaskFunction* takeSlot();
+	void releaseSlot(TaskFunction* slot);
+	void allocateSlots();	// Under lockSlots
+
+	void push(TaskFunction task, TaskPriority priority);
+
+	TaskFunction* popInjected(size_t lane);
+	TaskFunction* steal(int thiefIndex, size_t lane);
+
+	// Lane by lane: local deque, then injection queue, then the other workers
+	TaskFunction* findTask(int index, TaskPriority& priority);
+	void run(TaskFunction* task, TaskPriority priority);
+
+	bool canRunBackground() const;
+	bool hasTask();
+
+	// Spin, then yield, then park: a task if one is found before parking
+	TaskFunction* waitTask(int index, TaskPriority& priority);
+	void park();
+	void wakeOne();
+
+	void threadRoutine(int index);
 
 	bool initialized = false;
-	bool finish = false;
+	std::atomic<bool> finish{ false };
 
 	std::atomic<int> count{ 0 };
 	std::atomic<unsigned int> countEnd{ 0 };
-};
\ No newline at end of file
+};
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+// Chase-Lev work-stealing deque of pointers (Le, Pop, Cohen, Zappa Nardelli, "Correct and efficient work-stealing for weak
+// memory models"). Its owner thread pushes and pops at the bottom without lock, the other threads steal at the top
+template <class T>
+class WorkDeque
+{
+private:
+	struct Buffer
+	{
+		int64_t capacity;
+		std::unique_ptr<std::atomic<T*>[]> slots;
+
+		Buffer(int64_t capacity)
+			: capacity(capacity), slots(new std::atomic<T*>[(size_t)capacity])
+		{}
+
+		T* get(int64_t i) const
+		{
+			return slots[(size_t)(i & (capacity - 1))].load(std::memory_order_relaxed);
+		}
+
+		void put(int64_t i, T* item)
+		{
+			slots[(size_t)(i & (capacity - 1))].store(item, std::memory_order_relaxed);
+		}
+	};
+
+	alignas(64) std::atomic<int64_t> top{ 0 };
+	alignas(64) std::atomic<int64_t> bottom{ 0 };
+	std::atomic<Buffer*> buffer{ nullptr };
+
+	// A thief can still read an old buffer, they are all kept until the deque is destroyed (owner only)
+	std::vector<std::unique_ptr<Buffer>> buffers;
+
+	Buffer* grow(Buffer* old, int64_t b, int64_t t)
+	{
+		buffers.push_back(std::make_unique<Buffer>(old->capacity * 2));
+		Buffer* grown = buffers.back().get();
+
+		for (int64_t i = t; i < b; i++)
+			grown->put(i, old->get(i));
+
+		buffer.store(grown, std::memory_order_release);
+
+		return grown;
+	}
+
+public:
+	WorkDeque(int64_t capacity = 256)
+	{
+		buffers.push_back(std::make_unique<Buffer>(capacity));
+		buffer.store(buffers.back().get(), std::memory_order_relaxed);
+	}
+
+	WorkDeque(const WorkDeque&) = delete;
+	WorkDeque& operator=(const WorkDeque&) = delete;
+
+	// Owner only
+	void push(T* item)
+	{
+		int64_t b = bottom.load(std::memory_order_relaxed);
+		int64_t t = top.load(std::memory_order_acquire);
+		Buffer* buf = buffer.load(std::memory_order_relaxed);
+
+		if (b - t > buf->capacity - 1)
+			buf = grow(buf, b, t);
+
+		buf->put(b, item);
+
+		std::atomic_thread_fence(std::memory_order_release);
+		bottom.store(b + 1, std::memory_order_relaxed);
+	}
+
+	// Owner only, the last pushed item (nullptr if empty or taken by a thief)
+	T* pop()
+	{
+		int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+		Buffer* buf = buffer.load(std::memory_order_relaxed);
+
+		bottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		int64_t t = top.load(std::memory_order_relaxed);
+
+		if (t > b)
+		{
+			bottom.store(b + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		T* item = buf->get(b);
+
+		// Last item, race with the thieves for it
+		if (t == b)
+		{
+			if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				item = nullptr;
+
+			bottom.store(b + 1, std::memory_order_relaxed);
+		}
+
+		return item;
+	}
+
+	// Any thread, the oldest item (nullptr if empty or lost to another thief)
+	T* steal()
+	{
+		int64_t t = top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t b = bottom.load(std::memory_order_acquire);
+
+		if (t >= b)
+			return nullptr;
+
+		Buffer* buf = buffer.load(std::memory_order_acquire);
+		T* item = buf->get(t);
+
+		if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			return nullptr;
+
+		return item;
+	}
+
+	bool empty() const
+	{
+		return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+	}
+};
@@ -4,6 +4,7 @@
 #include <deque>
 #include <atomic>
 
+#include "load_handle.hpp"
 #include "sub_model.hpp"
 
 #define COLLIDER_COLOR Core::Maths::vec3(0.f, 1.f, 0.f)
@@ -20,6 +21,9 @@ namespace LowRenderer
 	private:
 		std::string m_filePath;
 
+		// Completed when every mesh, material and texture of the model is GPU-resident
+		std::shared_ptr<Resources::LoadHandle> m_loadHandle = nullptr;
+
 	public:
 
 		std::deque<SubModel> m_subModels;
@@ -39,6 +43,9 @@ namespace LowRenderer
 		void setDiffuseTexture(const std::string& difTexName);
 
 		std::string getPath() const;
+
+		void setLoadHandle(const std::shared_ptr<Resources::LoadHandle>& loadHandle);
+		std::shared_ptr<Resources::LoadHandle> getLoadHandle() const;
 	};
 
 	/*class Model
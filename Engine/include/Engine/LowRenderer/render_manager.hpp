@@ -9,6 +9,7 @@
 #include "sprite_renderer.hpp"
 #include "model_renderer.hpp"
 #include "benchmark.hpp"
+#include "character.hpp"
 #include "sky_box.hpp"
 #include "camera.hpp"
 #include "light.hpp"
@@ -31,6 +32,12 @@ namespace LowRenderer
 		std::vector<std::shared_ptr<Light>> lights;
 		std::vector<std::shared_ptr<Camera>> cameras;
 		std::vector<std::shared_ptr<SkyBox>> skyBoxes;
+		std::vector<std::shared_ptr<Resources::Text>> texts;
+
+		// Vertices of all the texts of a font, streamed in one buffer and drawn at once
+		std::vector<Resources::TextVertex> textVertices;
+		GLuint textVAO = 0;
+		GLuint textVBO = 0;
 
 		std::shared_ptr<Resources::Texture>			benchTexs[2];
 		std::shared_ptr<Resources::Mesh>			benchMesh;
@@ -41,6 +48,7 @@ namespace LowRenderer
 		void drawShadows();
 		void drawModels();
 		void drawSprites();
+		void drawTexts();
 		void drawBenchmark();
 
 	public:
@@ -63,8 +71,11 @@ namespace LowRenderer
 
 		static void linkComponent(const std::shared_ptr<ColliderRenderer>& compToLink);
 
+		static void linkComponent(const std::shared_ptr<Resources::Text>& compToLink);
+
 		static void removeComponent(SpriteRenderer* compToRemove);
 		static void removeComponent(ModelRenderer* compToRemove);
+		static void removeComponent(Resources::Text* compToRemove);
 
 		template <class C>
 		static void clearComponents();
@@ -104,5 +115,11 @@ namespace LowRenderer
 		{
 			instance()->colliders.clear();
 		}
+
+		template<>
+		static void clearComponents<Resources::Text>()
+		{
+			instance()->texts.clear();
+		}
 	};
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "texture_atlas.hpp"
 #include "renderer.hpp"
 #include "texture.hpp"
 #include "mesh.hpp"
@@ -12,11 +13,16 @@ namespace LowRenderer
 		std::shared_ptr<Resources::Mesh> mesh = nullptr;
 		std::shared_ptr<Resources::Texture> texture = nullptr;
 
+		// Small images are drawn from a page of the texture atlas instead of their own texture
+		std::shared_ptr<Resources::AtlasRegion> region = nullptr;
+
 		float tillingMultiplier = 1.f;
 		float tillingOffset = 0.f;
 
 		void onDestroy() override;
 
+		void setTexture(const std::string& texturePath, bool isMulti);
+
 	public:
 		Core::Maths::vec4 m_color = Core::Maths::vec4(1.f, 1.f, 1.f, 1.f);
 
@@ -26,6 +32,9 @@ namespace LowRenderer
 
 		std::string getTexturePath();
 
+		// Texture to bind before draw (the atlas page of the region), 0 while it is not uploaded
+		GLuint getTextureID() const;
+
 		void draw() const override;
 		void drawImGui() override;
 		std::string toString() const override;
@@ -5,6 +5,7 @@
 #include <string>
 
 #include "singleton.hpp"
+#include "task_graph.hpp"
 
 namespace Core::Engine
 {
@@ -21,12 +22,54 @@ namespace Core::Engine
 		std::chrono::steady_clock::time_point endLoad;
 
 		long sceneTrianglesCount = 0;
+		long sceneVerticesCount  = 0;
+		long sceneSourceVerticesCount = 0; // Before the vertices deduplication
 		long sceneTexturesCount  = 0;
 		long sceneModelsCount    = 0;
 		long sceneObjectsCount	 = 0; // Objects can have the same model
 
+		size_t peakMemoryUsage = 0; // Process peak resident memory at the end of the last loading
+
+		// Global allocator calls and tasks too big for their buffer during the last loading, counted from startTimer to endTimer
+		size_t startAllocationsCount = 0;
+		size_t startHeapTasksCount = 0;
+		size_t sceneAllocationsCount = 0;
+		size_t sceneHeapTasksCount = 0;
+
+		// Time between the loading start and the first submesh uploaded (seconds)
+		bool isFirstMeshVisible = false;
+		float firstVisibleTime = 0.f;
+
+		// Time between the loading start and the critical objects loaded, the rest keeps loading (seconds)
+		std::atomic<float> interactiveTime {0.f};
+
 		std::atomic<bool> onBenchmark {false};
 
+		// Obj parsing throughput, per parser (microseconds)
+		std::atomic<long long> streamParsedBytes {0};
+		std::atomic<long long> streamParsingTime {0};
+		std::atomic<long long> mappedParsedBytes {0};
+		std::atomic<long long> mappedParsingTime {0};
+		std::atomic<long long> meshCacheBytes {0};
+		std::atomic<long long> meshCacheTime {0};
+		std::atomic<long long> streamPreScanTime {0};	// Reserve pass of the stream parser, out of its throughput
+
+		// GL storage of the textures alive (bytes)
+		std::atomic<long long> texturesMemory {0};
+
+		// Textures sharing the texture of the same file content, and the bytes of their files
+		std::atomic<long> dedupTexturesCount {0};
+		std::atomic<long long> dedupTexturesBytes {0};
+
+		// Models load latency, from loadObj to the last upload (microseconds)
+		std::atomic<long long> modelsLoadingTime {0};
+		std::atomic<long long> modelsLoadingMaxTime {0};
+		std::atomic<long> modelsLoadedCount {0};
+
+		// Task graph of the last scene loaded (GL thread)
+		size_t sceneTasksCount = 0;
+		std::vector<Core::TaskGroup::Step> criticalPath;
+
 	public:
 		std::vector<float> loadingTimesMono;
 		std::vector<float> loadingTimesMulti;
@@ -38,14 +81,56 @@ namespace Core::Engine
 		static Benchmark* getInstance();
 
 		static void addTrianglesCount(long count);
+		static void addVerticesCount(long sourceCount, long count);
+
+		// Call when a submesh can be drawn (GL thread)
+		static void setMeshVisible();
+
+		// Call once the objects near the camera are loaded (any thread)
+		static void setInteractive();
 		static void addTexturesCount(long count);
+		static void addTexturesMemory(long long bytes); // Negative when a texture is deleted
+		static void addTextureDeduplicated(long long fileBytes);
 		static void addModelsCount(long count);
 		static void addObjectsCount(long count);
+		static void addObjParsing(bool isMapped, long long bytes, long long microseconds);
+		static void addMeshCacheLoading(long long bytes, long long microseconds);
+		static void addObjPreScan(long long microseconds);
+		static void addModelLoading(float seconds);
+
+		// Once the scene tasks are done
+		static void setSceneTasks(Core::TaskGroup& tasks);
 
 		long getTrianglesCount();
+		long getVerticesCount();
+		long getSourceVerticesCount();
 		long getTexturesCount();
 		long getModelsCount();
 		long getObjectsCount();
+		float getPeakMemoryUsage(); // MB
+		size_t getAllocationsCount();
+		size_t getHeapTasksCount();
+		float getTexturesMemory(); // MB
+		long getDeduplicatedTexturesCount();
+		float getDeduplicatedTexturesMemory(); // MB of files not decoded
+		float getFirstVisibleTime();
+		float getInteractiveTime();
+
+		// Return the obj parsers throughput in MB/s
+		float getStreamParsingSpeed();
+		float getMappedParsingSpeed();
+		float getMeshCacheSpeed();
+
+		// Seconds of the pre-scans reserving the stream parser vectors
+		float getStreamPreScanTime();
+
+		// Average and max model load latency in seconds
+		float getModelLoadingTime();
+		float getModelLoadingMaxTime();
+
+		size_t getSceneTasksCount();
+		const std::vector<Core::TaskGroup::Step>& getCriticalPath();
+		float getCriticalPathTime(); // Seconds
 
 		float getAverageMono();
 		float getAverageMulti();
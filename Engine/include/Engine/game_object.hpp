@@ -30,6 +30,9 @@ namespace Engine
 
 		std::string m_recipe = "";
 
+		// Lane of its loadings written in the scene (critical, normal or background), chosen from the camera distance when empty
+		std::string m_loadPriority = "";
+
 		std::vector<std::shared_ptr<Component>> m_components;
 
 		GameObject() = default;
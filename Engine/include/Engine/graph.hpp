@@ -1,11 +1,12 @@
 #pragma once
-#include <functional>
 #include <atomic>
 #include <chrono>
-#include <queue>
+#include <vector>
+#include <array>
 
 #include "singleton.hpp"
 #include "benchmark.hpp"
+#include "thread_pool.hpp"
 
 #include "scene.hpp"
 #include "game_object.hpp"
@@ -25,6 +26,9 @@ namespace Core::Engine
 		void drawBenchmark();
 		void benchmark();
 
+		// Every task of the current scene graph ended
+		bool isSceneLoaded() const;
+
 		bool showDemoWindowImGui = false;
 		bool isMultithreaded = true;
 		bool hasToReload = false;
@@ -33,9 +37,20 @@ namespace Core::Engine
 
 		Resources::Scene curScene;
 
-		std::queue<std::function<void()>> requests;
+		// Requests of a lane, run from the first not run (cleared once all are, its capacity is kept)
+		struct RequestsQueue
+		{
+			std::vector<TaskFunction> requests;
+			size_t first = 0;
+		};
+
+		// One queue per lane, the critical requests are run first
+		std::array<RequestsQueue, (size_t)TaskPriority::COUNT> requests;
 		std::atomic_flag requestFlag = ATOMIC_FLAG_INIT;
 
+		// Requests of the frame, run out of the lock (main thread only)
+		std::vector<TaskFunction> dueRequests;
+
 		Benchmark* bench = nullptr;
 
 	public:
@@ -44,20 +59,8 @@ namespace Core::Engine
 
 		//static Graph* getInstance() { return instance(); }
 
-		template <typename Request>
-		static void addRequest(Request request)
-		{
-			Graph* graph = instance();
-
-			if (graph == nullptr)
-				return;
-
-			while (graph->requestFlag.test_and_set());
-
-			graph->requests.push(std::function<void()>(request));
-
-			graph->requestFlag.clear();
-		}
+		// In the lane of the task requesting it
+		static void addRequest(TaskFunction request);
 
 		static void saveCurrentScene();
 
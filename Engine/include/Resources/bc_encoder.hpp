@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Resources::BC
+{
+	// Block compressed formats, 4x4 pixels per block
+	enum class Format : unsigned int
+	{
+		BC1,	// RGB, 8 bytes per block
+		BC3,	// RGBA (BC1 color + BC4 alpha), 16 bytes per block
+		BC4,	// R, 8 bytes per block
+		BC5		// RG (two BC4), 16 bytes per block
+	};
+
+	// Format of an 8 bits image of the given channels count, RGBA images without transparency use BC1
+	Format getFormat(const unsigned char* pixels, int width, int height, int channels);
+
+	size_t getBlockSize(Format format);
+	size_t getLevelSize(Format format, int width, int height);
+
+	// Compress a whole 8 bits image, output must have getLevelSize(format, width, height) bytes.
+	// Blocks crossing the image border repeat its last row and column
+	void compress(Format format, const unsigned char* pixels, int width, int height, int channels, unsigned char* output);
+}
@@ -1,46 +1,107 @@
 #pragma once
 
-#include <unordered_map>
-#include <ft2build.h>
-#include FT_FREETYPE_H
+#include <array>
+#include <string>
+#include <vector>
 
+#include <glad/glad.h>
+
+#include "load_handle.hpp"
+#include "renderer.hpp"
+#include "resource.hpp"
 #include "maths.hpp"
-#include "component.hpp"
-#include "shader.hpp"
+
+#define FONT_PIXEL_SIZE 48
+#define FONT_FIRST_CHAR 32			// Space, the control characters have no glyph
+#define FONT_LAST_CHAR 126
+#define FONT_PADDING 1				// Empty pixels around each glyph, so the filtering does not read the neighbours
+#define FONT_MAX_ATLAS_SIZE 4096
 
 namespace Resources
 {
+	// Metrics in pixels at FONT_PIXEL_SIZE, and place of the glyph in the font atlas
 	struct Character
 	{
-		unsigned int ID;
 		Core::Maths::vec2 size;
 		Core::Maths::vec2 bearing;
-		unsigned int advance;
+		float advance = 0.f;
+		Core::Maths::vec4 uvRect;	// Min corner (xy) and size (zw)
+	};
+
+	// Vertex of the text batch
+	struct TextVertex
+	{
+		Core::Maths::vec4 position;	// xy position in the camera space, zw UVs
+		Core::Maths::vec4 color;
 	};
 
-	class Font
+	// All the glyphs of a font rasterized and packed in one R8 texture by a loading thread, uploaded at once
+	class Font : public Resource
 	{
 	private:
-		std::unordered_map<char, Character> charMap;
+		GLuint ID = 0;
+
+		int atlasSize = 0;
+		std::vector<unsigned char> atlas;
+
+		std::array<Character, FONT_LAST_CHAR - FONT_FIRST_CHAR + 1> charMap;
+		float lineHeight = 0.f;
+
+		bool rasterize(const std::string& filePath);
+
 	public:
-		Font(const std::string& path);
+		bool isDrawable = false;
+		LoadWaiters loadWaiters;
+
+		Font() = default;
+		~Font();
+
+		void create(const std::string& filePath, bool isOnRequest);
+
+		// GL thread
+		void generate();
+
+		GLuint getID() const;
+
+		// nullptr for the characters out of the font
+		const Character* getCharacter(char c) const;
+		float getLineHeight() const;
 	};
 
-	class Text : public Engine::Component
+	// String drawn with the glyphs of a font, all the texts of a font are batched in one draw call by the render manager
+	class Text : public LowRenderer::Renderer
 	{
 	private:
-		std::shared_ptr<ShaderProgram> m_shaderProgram = nullptr;
 		std::shared_ptr<Font> m_font = nullptr;
+		std::string m_text;
+
+		// Quads of the string in the text space (xy position, zw UVs), built again when the string changes
+		mutable std::vector<Core::Maths::vec4> vertices;
+		mutable bool isDirty = true;
+
+		void onDestroy() override;
+
+		void buildVertices() const;
 
 	public:
-		Text(Engine::GameObject& gameObject, const std::string& path);
-		Text(Engine::GameObject& gameObject, std::shared_ptr<Text> ptr);
-		~Text();
+		Core::Maths::vec4 m_color = Core::Maths::vec4(1.f, 1.f, 1.f, 1.f);
+
+		Text(Engine::GameObject& gameObject, const std::string& fontPath, const std::string& text, bool isMulti);
+		Text(Engine::GameObject& gameObject, const std::shared_ptr<Text>& ptr);
+
+		void setText(const std::string& text);
+		const std::string& getText() const;
+
+		const std::shared_ptr<Font>& getFont() const;
 
-		void draw() const;
+		// Append the quads of the string, moved by the global model of the text, to the frame batch
+		void batch(std::vector<TextVertex>& batchVertices) const;
 
+		// Drawn in the batch of its font
+		void draw() const override {}
+		void drawImGui() override;
 		std::string toString() const override;
 
-		static void parseComponent(Engine::GameObject& gameObject, std::istringstream& iss);
+		static void parseComponent(Engine::GameObject& gameObject, std::istringstream& iss, bool isMulti);
 	};
-}
\ No newline at end of file
+}
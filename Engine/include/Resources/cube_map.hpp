@@ -3,21 +3,39 @@
 #include <string>
 #include <vector>
 #include <array>
+#include <atomic>
 #include <memory>
 
 #include <glad/glad.h>
 
+#include "cube_map_cache.hpp"
+#include "load_handle.hpp"
+#include "task_graph.hpp"
 #include "texture.hpp"
+#include "mipmap.hpp"
 
 namespace Resources
 {
 	class CubeMap
 	{
 	private:
-		GLuint ID = -1;
+		GLuint ID = 0;
 
-		std::array<unsigned char*, 6> datas;
-		std::array<int, 12> dimensions;
+		std::array<std::string, 6> paths;
+
+		// Each face is decoded by its own job: RGBA pixels with their mips, or their BC1 blocks when cached
+		std::array<unsigned char*, 6> datas = {};
+		std::array<Mipmap::Chain, 6> mips;
+		CubeMapCache::Faces compressed;
+
+		bool isOnRequest = false;
+		bool useCache = false;
+		size_t residentSize = 0;
+
+		void loadFace(size_t index);
+		void endFaces();
+		void upload();
+		void freeFaces();
 
 	public:
 		//CubeMap(const std::vector<std::string>& paths);
@@ -26,11 +44,17 @@ namespace Resources
 
 		bool isDrawable = false;
 
-		void create(const std::vector<std::string>& paths, bool isMulti);
+		// Loadings waiting for the upload of this cube map
+		LoadWaiters loadWaiters;
+
+		// Faces decoded on the pool when isMulti, upload through the Graph requests when isOnRequest.
+		// The faces are tasks of the given group (their own group without it), joined by the upload
+		void create(const std::vector<std::string>& paths, bool isMulti, bool isOnRequest, bool useCache = false,
+			const std::shared_ptr<Core::TaskGroup>& tasks = nullptr);
 		void generate();
 
 		GLuint getID() const;
 
 		void bind() const;
 	};
-}
\ No newline at end of file
+}
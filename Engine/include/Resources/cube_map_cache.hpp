@@ -0,0 +1,24 @@
+#pragma once
+
+#include <array>
+#include <string>
+
+#include "texture_cache.hpp"
+
+// Increase when the cube map cache layout changes
+#define CUBE_MAP_CACHE_VERSION 1
+
+namespace Resources::CubeMapCache
+{
+	// The six faces with their filtered mips, in BC1
+	using Faces = std::array<TextureCache::CompressedImage, 6>;
+
+	// Path of the cache file of a cube map (folder of its faces, cubemap_<hash of the face names>.cube)
+	std::string getCachePath(const std::array<std::string, 6>& facePaths);
+
+	// Map the cache of the cube map, fail if missing, of another version, if a face changed since or if their mip chains differ
+	bool read(const std::array<std::string, 6>& facePaths, Faces& faces);
+
+	// Write the cache of the cube map, keyed on the size and last write time of each face
+	bool write(const std::array<std::string, 6>& facePaths, const Faces& faces);
+}
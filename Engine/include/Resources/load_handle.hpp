@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <vector>
+#include <functional>
+
+#include "task_graph.hpp"
+
+namespace Resources
+{
+	// Completion state of a loading (a model, a scene), done once every job it tracks is GPU-resident
+	class LoadHandle
+	{
+	public:
+		enum class JobType
+		{
+			LOADING,	// The loading task itself (parsing, scene reading)
+			MESH,		// A mesh waiting for its VAO
+			MATERIAL,	// A mtl file being parsed
+			TEXTURE,	// A texture or a cube map waiting for its upload
+			COUNT
+		};
+
+		using CompletedCallback = std::function<void(float)>;
+
+	private:
+		std::shared_ptr<LoadHandle> m_parent = nullptr;
+
+		// Every job is forwarded to the parent, it is completed after its children
+		std::atomic<int> pendingJobs{ 1 };
+		std::array<std::atomic<int>, (size_t)JobType::COUNT> pendingJobsByType;
+
+		std::promise<void> promise;
+		std::shared_future<void> future;
+		std::atomic_flag isCompleted = ATOMIC_FLAG_INIT;
+
+		std::chrono::steady_clock::time_point startTime;
+		std::atomic<long long> loadingTime{ 0 }; // microseconds
+
+		CompletedCallback m_onCompleted;
+
+		void complete();
+
+	public:
+		// The handle starts with its LOADING job, end it when the loading task is over
+		LoadHandle(const std::shared_ptr<LoadHandle>& parent = nullptr, const CompletedCallback& onCompleted = nullptr);
+
+		LoadHandle(const LoadHandle&) = delete;
+		LoadHandle& operator=(const LoadHandle&) = delete;
+
+		void addJob(JobType type);
+		void endJob(JobType type);
+
+		bool isReady() const;
+		void wait() const;
+		std::shared_future<void> getFuture() const;
+
+		int getPendingJobs() const;
+		int getPendingJobs(JobType type) const;
+
+		// Seconds between the handle creation and its completion (0 while pending)
+		float getLoadingTime() const;
+	};
+
+	// Handles and task graph events waiting for a shared resource (texture, cube map) that can be requested while it is loading
+	class LoadWaiters
+	{
+	private:
+		std::vector<std::pair<std::shared_ptr<LoadHandle>, LoadHandle::JobType>> waiters;
+		std::vector<std::shared_ptr<Core::Task>> events;
+		std::atomic_flag lock = ATOMIC_FLAG_INIT;
+		bool isReleased = false;
+
+	public:
+		// Add a job on the handle until release, nothing if the resource is already loaded
+		void add(const std::shared_ptr<LoadHandle>& handle, LoadHandle::JobType type);
+
+		// End the event on release, right away if the resource is already loaded
+		void addEvent(const std::shared_ptr<Core::Task>& event);
+
+		// End the jobs of the waiting handles and the events, call once the resource is loaded (or failed)
+		void release();
+	};
+}
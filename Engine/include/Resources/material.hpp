@@ -35,6 +35,13 @@ namespace Resources
 		void sendToShader(const std::shared_ptr<Resources::ShaderProgram>& shaderProgram) const;
 		void bindTextures() const;
 
-		bool isDrawable = false;
+		// Set (release) once every field is written by its mtl, read (acquire) before drawing
+		std::atomic<bool> isDrawable{ false };
+
+		// Only the first mtl parsing of a material writes it, return true for this one
+		bool claim();
+
+	private:
+		std::atomic_flag isClaimed = ATOMIC_FLAG_INIT;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <vector>
+#include <string>
+
+#include "mtl_parser.hpp"
+
+// Increase when the material cache layout changes
+#define MATERIAL_CACHE_VERSION 1
+
+namespace Resources::MaterialCache
+{
+	// Path of the cache file of a mtl (same folder, .mat extension)
+	std::string getCachePath(const std::string& mtlPath);
+
+	// Read the cache of the mtl, fail if missing, of another version, or if the mtl changed since
+	bool read(const std::string& mtlPath, std::vector<Mtl::MaterialData>& materials);
+
+	// Write the cache of the mtl, keyed on the mtl path, size and last write time
+	bool write(const std::string& mtlPath, const std::vector<Mtl::MaterialData>& materials);
+}
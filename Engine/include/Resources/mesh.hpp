@@ -3,32 +3,49 @@
 #include <vector>
 #include <string>
 #include <atomic>
+#include <memory>
 
 #include <glad\glad.h>
 
+#include "mesh_data.hpp"
+#include "mapped_file.hpp"
 #include "resource.hpp"
 
 #include "maths.hpp"
 
 namespace Resources
 {
-	class Mesh : public Resource
+	class Mesh : public Resource, public MeshData
 	{
 	private:
 		GLuint VAO = 0;
 		GLuint VBO = 0;
+		GLuint EBO = 0;
+
+		// Attributs and indices read from a mesh cache, the file stays mapped until the upload
+		std::shared_ptr<Utils::MappedFile> cacheFile = nullptr;
+		const unsigned char* cachedAttributs = nullptr;
+		size_t cachedAttributsSize = 0;
+		const unsigned char* cachedIndices = nullptr;
+
+		GLenum getIndexType() const;
+		void setAttribPointers() const;
 
 	public:
+		Mesh() = default;
 		~Mesh();
 
-		long verticesCount = 0;
+		// Meshes own GL buffers and large CPU buffers: move only
+		Mesh(const Mesh&) = delete;
+		Mesh& operator=(const Mesh&) = delete;
+		Mesh(Mesh&& other) noexcept;
+		Mesh& operator=(Mesh&& other) noexcept;
 
-		std::vector<float> attributs;
 		std::string name;
 		bool isDrawable = false;
 
 		void draw() const;
 		void generateVAO();
-		void compute(std::vector<Core::Maths::vec3>& vertices, std::vector<Core::Maths::vec3>& texCoords, std::vector<Core::Maths::vec3>& normals, std::vector<unsigned int>& indices);
+		void setCachedData(const std::shared_ptr<Utils::MappedFile>& file, const unsigned char* _attributs, size_t attributsSize, const unsigned char* _indices);
 	};
 }
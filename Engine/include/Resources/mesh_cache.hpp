@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <memory>
+
+#include "vertex_layout.hpp"
+#include "mapped_file.hpp"
+
+// Increase when the cache layout or the mesh attributs change
+#define MESH_CACHE_VERSION 4
+
+namespace Resources::MeshCache
+{
+	// Submesh of a cache file, attributs and indices point in the file mapping when read
+	struct SubMesh
+	{
+		std::string name;
+		std::string matName;
+
+		long verticesCount = 0;
+		long indicesCount = 0;
+		long sourceVerticesCount = 0;
+		unsigned int indexSize = 0;
+
+		const unsigned char* attributs = nullptr;
+		size_t attributsSize = 0;
+		const unsigned char* indices = nullptr;
+	};
+
+	struct CachedModel
+	{
+		std::shared_ptr<Utils::MappedFile> file;
+
+		std::vector<std::string> mtlLibs;
+		std::vector<SubMesh> subMeshes;
+	};
+
+	// Path of the cache file of an obj (same folder, .mesh extension)
+	std::string getCachePath(const std::string& objPath);
+
+	// Map the cache of the obj, fail if missing, of another version or layout, or if the obj changed since
+	bool read(const std::string& objPath, VertexLayout layout, CachedModel& model);
+
+	// Write the cache of the obj, keyed on the obj path, size and last write time
+	bool write(const std::string& objPath, VertexLayout layout, const std::vector<std::string>& mtlLibs, const std::vector<SubMesh>& subMeshes);
+}
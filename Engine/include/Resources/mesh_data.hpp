@@ -0,0 +1,26 @@
+#pragma once
+
+#include <vector>
+
+#include "vertex_layout.hpp"
+
+#include "maths.hpp"
+
+namespace Resources
+{
+	// CPU side of a mesh: deduplicated vertices and their indices, no GL needed to compute it
+	struct MeshData
+	{
+		long verticesCount = 0;			// Unique vertices
+		long indicesCount = 0;
+		long sourceVerticesCount = 0;	// Face corners, before the deduplication
+
+		VertexLayout layout = VertexLayout::STANDARD;
+		std::vector<unsigned char> attributs;	// Vertex::getSize(layout) bytes per vertex
+		std::vector<unsigned char> indices;		// 16 or 32 bits each, depending on indexSize
+		unsigned int indexSize = sizeof(unsigned int);
+
+		void compute(std::vector<Core::Maths::vec3>& vertices, std::vector<Core::Maths::vec3>& texCoords, std::vector<Core::Maths::vec3>& normals, std::vector<unsigned int>& indices, VertexLayout _layout);
+		void compute(const std::vector<Core::Maths::vec3>& vertices, const std::vector<Core::Maths::vec3>& texCoords, const std::vector<Core::Maths::vec3>& normals, const unsigned int* cornerIndices, size_t cornerIndicesCount, VertexLayout _layout);
+	};
+}
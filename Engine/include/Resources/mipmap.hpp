@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+namespace Resources::Mipmap
+{
+	enum class Filter
+	{
+		BOX,	// 2x2 average, the cheapest
+		KAISER	// 6 taps Kaiser windowed sinc, sharper levels with less aliasing
+	};
+
+	// One level of a mip chain, in the components type of the source (8 bits or float)
+	struct Level
+	{
+		int width = 0;
+		int height = 0;
+		const void* pixels = nullptr;	// Level 0 points to the source image
+		size_t size = 0;				// Bytes
+	};
+
+	// Full mip chain of an image, the levels 1 and up are in data (so it can be moved, not copied)
+	struct Chain
+	{
+		std::vector<Level> levels;
+		std::vector<unsigned char> data;
+
+		Chain() = default;
+		Chain(Chain&&) = default;
+		Chain& operator=(Chain&&) = default;
+		Chain(const Chain&) = delete;
+		Chain& operator=(const Chain&) = delete;
+
+		size_t getSize() const;
+	};
+
+	// Levels count of a full mip chain, down to 1x1
+	int getLevelsCount(int width, int height);
+
+	// Size of the level under a width x height one
+	int getNextSize(int size);
+
+	// Build the whole chain of an 8 bits image, each level filtered from the previous one kept in floats.
+	// The color channels of RGB and RGBA images are sRGB, they are filtered in linear space; grey and alpha channels as they are
+	void generate(const unsigned char* pixels, int width, int height, int channels, Chain& chain, Filter filter = Filter::KAISER);
+
+	// Same for float (HDR) images, already linear
+	void generate(const float* pixels, int width, int height, int channels, Chain& chain, Filter filter = Filter::KAISER);
+}
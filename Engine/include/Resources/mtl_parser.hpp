@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <istream>
+
+#include "color.hpp"
+
+namespace Resources::Mtl
+{
+	// Material as read from a mtl file, textures are kept as file names (no GL needed)
+	struct MaterialData
+	{
+		std::string name;
+
+		LowRenderer::Color ambient = { 0.2f, 0.2f, 0.2f, 1.0f };
+		LowRenderer::Color diffuse = { 0.8f, 0.8f, 0.8f, 1.0f };
+		LowRenderer::Color specular = { 0.0f, 0.0f, 0.0f, 1.0f };
+		LowRenderer::Color emissive = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+		float shininess = 100.f;
+		float opticalDensity = 0.f;
+		float transparency = 0.f;
+		float illumination = 0.f;
+
+		// Empty when the material has no such map
+		std::string alphaTex;
+		std::string ambientTex;
+		std::string diffuseTex;
+		std::string emissiveTex;
+		std::string specularTex;
+	};
+
+	// Read every newmtl of a mtl stream, in file order
+	std::vector<MaterialData> parse(std::istream& stream);
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <functional>
+
+#include "maths.hpp"
+
+// Under this size per chunk, an obj is parsed by one thread
+#define OBJ_CHUNK_MIN_SIZE (4 * 1024 * 1024)
+
+// Index of a vt or vn missing from a face corner
+#define OBJ_MISSING_INDEX 0xFFFFFFFFu
+
+namespace Resources::Obj
+{
+	// Part of an obj between two o/g keywords, refers to a range of Data::indices
+	struct Group
+	{
+		std::string name;
+		std::string matName = "default";
+
+		size_t indicesBegin = 0;
+		size_t indicesEnd = 0;
+	};
+
+	// Everything read from an obj file, indices are stored as 0-based v/vt/vn triplets
+	// (OBJ_MISSING_INDEX for the vt and vn not given by the face)
+	struct Data
+	{
+		std::vector<Core::Maths::vec3> vertices;
+		std::vector<Core::Maths::vec3> texCoords;
+		std::vector<Core::Maths::vec3> normals;
+		std::vector<unsigned int> indices;
+
+		std::vector<Group> groups;
+		std::vector<std::string> mtlLibs;
+	};
+
+	// Records count of an obj buffer, indices are counted once the faces are triangulated
+	struct Counts
+	{
+		size_t vertices = 0;
+		size_t texCoords = 0;
+		size_t normals = 0;
+		size_t indices = 0;
+	};
+
+	using MtlLibCallback = std::function<void(const std::string&)>;
+
+	// Called as soon as a group is closed, its vertices and indices are already parsed
+	using GroupCallback = std::function<void(const Group&)>;
+
+	// Keyword met while parsing a chunk, replayed in order when merging
+	struct Event
+	{
+		enum class Type
+		{
+			OBJECT,
+			MATERIAL,
+			MTLLIB
+		};
+
+		Type type;
+		std::string name;
+		size_t indicesPos; // Local to the chunk
+	};
+
+	// Line aligned part of an obj buffer, parsed independently of the others
+	struct Chunk
+	{
+		const char* begin = nullptr;
+		const char* end = nullptr;
+
+		std::vector<Core::Maths::vec3> vertices;
+		std::vector<Core::Maths::vec3> texCoords;
+		std::vector<Core::Maths::vec3> normals;
+		std::vector<unsigned int> indices;
+		std::vector<Event> events;
+
+		// Positions in indices of the negative (relative) indices, fixed up when merging
+		std::vector<size_t> relativeIndices;
+
+		// Position of the chunk data in the merged data
+		size_t verticesOffset = 0;
+		size_t texCoordsOffset = 0;
+		size_t normalsOffset = 0;
+		size_t indicesOffset = 0;
+	};
+
+	// Locale free number parsing, return the position after the parsed number
+	const char* parseFloat(const char* cur, const char* end, float& value);
+	const char* parseInt(const char* cur, const char* end, int& value);
+
+	// Single pass parser of the corners of a face line (after the f keyword), n-gons are fan triangulated.
+	// Negative indices are relative to the given counts of elements read so far
+	void parseFace(const char* begin, const char* end, size_t verticesCount, size_t texCoordsCount, size_t normalsCount, std::vector<unsigned int>& indices);
+
+	// Pre-scan of the buffer lines so the data vectors can be reserved to their exact size
+	Counts count(const char* begin, const char* end);
+
+	// Tokenize an obj text buffer in place (no per-line allocations)
+	void parse(const char* begin, const char* end, Data& data, const MtlLibCallback& onMtlLib = nullptr, const GroupCallback& onGroup = nullptr);
+
+	// Chunked parsing, the result is the same as parse():
+	// split -> parseChunk (parallel) -> prepareMerge -> mergeChunk (parallel) -> mergeGroups
+	std::vector<Chunk> split(const char* begin, const char* end, size_t chunksCount);
+	void parseChunk(Chunk& chunk);
+	void prepareMerge(std::vector<Chunk>& chunks, Data& data);
+	void mergeChunk(Chunk& chunk, Data& data);
+	void mergeGroups(const std::vector<Chunk>& chunks, Data& data, const MtlLibCallback& onMtlLib = nullptr);
+}
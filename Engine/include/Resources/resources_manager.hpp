@@ -7,7 +7,10 @@
 
 #include "singleton.hpp"
 #include "benchmark.hpp"
+#include "load_handle.hpp"
+#include "task_graph.hpp"
 
+#include "texture_atlas.hpp"
 #include "character.hpp"
 #include "cube_map.hpp"
 #include "material.hpp"
@@ -20,6 +23,13 @@
 
 namespace Resources
 {
+	// Obj parsing engine used by loadObj
+	enum class ObjParserType
+	{
+		STREAM,	// getline + istringstream
+		MAPPED	// memory-mapped in place tokenizer
+	};
+
 	class ResourcesManager final : public Singleton<ResourcesManager>
 	{
 		friend Singleton<ResourcesManager>;
@@ -32,6 +42,22 @@ namespace Resources
 
 		Core::Engine::Benchmark* bench = nullptr;
 
+		ObjParserType objParser = ObjParserType::MAPPED;
+		bool useMeshCache = true;
+		bool useTextureCache = true;
+		VertexLayout vertexLayout = VertexLayout::PACKED_NORMALS;
+
+		// Parent of the loadings started by the current scene
+		std::shared_ptr<LoadHandle> sceneLoadHandle = nullptr;
+
+		// Replaces it for the loadings started by this thread
+		static thread_local std::shared_ptr<LoadHandle> threadLoadHandle;
+
+		std::shared_ptr<LoadHandle> getSceneLoadHandle() const;
+
+		// Loading tasks of the current scene, with their dependencies
+		std::shared_ptr<Core::TaskGroup> sceneTasks = nullptr;
+
 		std::vector<std::shared_ptr<Resource>> defaultResources;
 
 		// Resources containers
@@ -42,6 +68,12 @@ namespace Resources
 		std::unordered_map<std::string, std::shared_ptr<CubeMap>>		cubeMaps;
 		std::unordered_map<std::string, std::shared_ptr<Font>>			fonts;
 
+		// First texture loaded from each file content (hash of its bytes), the next paths with the same bytes share it
+		std::unordered_map<uint64_t, std::weak_ptr<Texture>>			textureContents;
+
+		// Kept between the scenes, the atlas pages do not free their regions
+		std::unordered_map<std::string, std::shared_ptr<AtlasRegion>>	atlasRegions;
+
 		std::unordered_map<std::string, std::shared_ptr<LowRenderer::Model>>  models;
 
 		std::unordered_map<std::string, std::shared_ptr<ShaderProgram>> shaderPrograms;
@@ -56,6 +88,8 @@ namespace Resources
 		std::atomic_flag lockMeshes = ATOMIC_FLAG_INIT;
 		std::atomic_flag lockMaterials = ATOMIC_FLAG_INIT;
 		std::atomic_flag lockCubeMaps = ATOMIC_FLAG_INIT;
+		std::atomic_flag lockAtlasRegions = ATOMIC_FLAG_INIT;
+		std::atomic_flag lockFonts = ATOMIC_FLAG_INIT;
 
 		void setDefaultResources();
 		void loadDefaults();
@@ -72,11 +106,23 @@ namespace Resources
 			}
 		}
 
+		// Task of the scene graph (straight on the pool out of a scene loading), the waiters end its upload event
+		void startLoading(const std::string& name, TaskFunction loading, bool isMulti, LoadWaiters* waiters = nullptr);
+
+		// Event of the scene graph ended once the GL thread uploaded the resource, nullptr out of a scene loading
+		std::shared_ptr<Core::Task> addUploadEvent(const std::string& name);
+
 		void loadObjMono(const std::string& filePath, bool onBenchmark);
 		void loadObjMulti(const std::string& filePath);
+		void loadObjMapped(const std::string& filePath, std::shared_ptr<LowRenderer::Model> model, bool isMulti, bool onBenchmark);
+		bool loadObjFromCache(const std::string& filePath, const std::shared_ptr<LowRenderer::Model>& model, bool isMulti, bool onBenchmark);
 
-		void loadMaterialsFromMtlMono(const std::string& dirPath, const std::string& mtlName);
-		void loadMaterialsFromMtlMulti(const std::string& dirPath, const std::string& mtlName);
+		// Move a computed mesh on RM and link it to the model, its VAO upload is scheduled right away
+		std::shared_ptr<Mesh> addMesh(const std::shared_ptr<LowRenderer::Model>& model, Mesh&& mesh, const std::string& matName, bool isMulti, bool onBenchmark);
+
+		void loadMtlLib(const std::string& dirPath, const std::string& mtlName, bool isMulti, const std::shared_ptr<LoadHandle>& loadHandle);
+
+		void loadMaterialsFromMtl(const std::string& dirPath, const std::string& mtlName, bool isMulti, const std::shared_ptr<LoadHandle>& loadHandle);
 
 	public:
 		static void init();
@@ -84,17 +130,48 @@ namespace Resources
 		static void clearTextures();
 		static void clearResources();
 
+		// The model load handle (Model::getLoadHandle) is completed once the model is GPU-resident
 		static std::shared_ptr<LowRenderer::Model> loadObj(const std::string& filePath, bool isMulti = true);
 
 		static std::shared_ptr<Material> loadMaterial(const std::string& matName);
-		static std::shared_ptr<Texture> loadTexture(const std::string& texName, bool isMultiThreaded = true);
+		static std::shared_ptr<Texture> loadTexture(const std::string& texName, bool isMultiThreaded = true, const std::shared_ptr<LoadHandle>& loadHandle = nullptr);
 		static std::shared_ptr<Texture> loadTexture(const std::string& name, int width, int height, float* data);
+
+		// Texture already loaded from the same bytes, or nullptr once the texture is registered as the first one of this content
+		static std::shared_ptr<Texture> shareTextureContent(uint64_t contentHash, const std::shared_ptr<Texture>& texture);
+
+		// Place of a small image in the texture atlas, nullptr for the images too big to be packed (use loadTexture)
+		static std::shared_ptr<AtlasRegion> loadAtlasRegion(const std::string& imageName, bool isMultiThreaded = true, const std::shared_ptr<LoadHandle>& loadHandle = nullptr);
 		static std::shared_ptr<Shader> loadShader(const std::string& shaderPath);
 		static std::shared_ptr<CubeMap> loadCubeMap(const std::vector<std::string>& cubeMapPaths, bool isMultiThreaded = true);
-		static std::shared_ptr<Font> loadFont(const std::string& fontPath);
+		static std::shared_ptr<Font> loadFont(const std::string& fontPath, bool isMultiThreaded = true);
 		static std::shared_ptr<ShaderProgram> loadShaderProgram(const std::string& programName, const std::string& vertPath = "", const std::string& fragPath = "", const std::string& geomPath = "");
 		static std::shared_ptr<Recipe> loadRecipe(const std::string& recipePath);
 
+		static void setObjParser(ObjParserType parserType);
+		static ObjParserType getObjParser();
+
+		// Binary .mesh cache written on the first (mapped) obj load and read on the next ones
+		static void setMeshCache(bool isEnabled);
+		static bool isMeshCacheEnabled();
+
+		// Block compressed .tex cache (with mips) written on the first texture load and read on the next ones
+		static void setTextureCache(bool isEnabled);
+		static bool isTextureCacheEnabled();
+
+		// Vertex format of the meshes loaded from now on
+		static void setVertexLayout(VertexLayout layout);
+		static VertexLayout getVertexLayout();
+
+		// Loadings without their own handle (sprites, cube maps) and the models ones are tracked by it
+		static void setSceneLoadHandle(const std::shared_ptr<LoadHandle>& loadHandle);
+
+		// Parent of the loadings started by this thread instead of the scene one (nullptr to stop), a child of the scene one
+		static void setThreadLoadHandle(const std::shared_ptr<LoadHandle>& loadHandle);
+
+		// The loadings started by the scene are tasks of this group
+		static void setSceneTasks(const std::shared_ptr<Core::TaskGroup>& tasks);
+
 		static std::shared_ptr<Mesh> getMeshByName(const std::string& meshName);
 		static std::shared_ptr<Material> getMatByName(const std::string& matName);
 	};
@@ -4,6 +4,11 @@
 
 #include "game_object.hpp"
 #include "model_renderer.hpp"
+#include "load_handle.hpp"
+#include "task_graph.hpp"
+
+// Objects nearer to the camera are loaded first, on the critical lane, unless their PRIORITY is set
+#define SCENE_CRITICAL_DISTANCE 300.f
 
 namespace Resources
 {
@@ -22,6 +27,12 @@ namespace Resources
 		std::string filePath;
 		std::unordered_map<std::string, Engine::GameObject> gameObjects;
 
+		// Completed when the scene file is read and every resource it requested is GPU-resident
+		std::shared_ptr<LoadHandle> loadHandle = nullptr;
+
+		// Reading of the scene file, the loadings it started and their uploads: done once the scene is loaded
+		std::shared_ptr<Core::TaskGroup> tasks = nullptr;
+
 		Scene() = default;
 		Scene(const std::string& path);
 		~Scene();
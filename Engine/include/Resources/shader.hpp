@@ -43,6 +43,7 @@ namespace Resources
 		~ShaderProgram();
 
 		void setUniform(const std::string& target, const void* value, int count = 1, bool transpose = false) const;
+		bool hasUniform(const std::string& target) const;
 		void bind() const;
 		void unbind() const;
 
@@ -2,40 +2,110 @@
 
 #include <string>
 #include <memory>
+#include <atomic>
 
 #include <glad/glad.h>
 
+#include "texture_uploader.hpp"
+#include "texture_cache.hpp"
+#include "mipmap.hpp"
+#include "load_handle.hpp"
 #include "resource.hpp"
 
 #include "maths.hpp"
 
 namespace Resources
 {
-	class Texture : public Resource
+	class Texture : public Resource, public std::enable_shared_from_this<Texture>
 	{
+		friend class TextureStreamer;
+
 	private:
 		GLuint textureID = 0;
 
 		int width = 0;
 		int height = 0;
-		float* colorBuffer = nullptr;
-		
+		int channels = 4;			// Kept from the image: R, RG, RGB or RGBA
+		bool isHDR = false;			// Float components, stored as half floats on the GPU
+		GLenum pixelType = GL_UNSIGNED_BYTE;
+		void* pixels = nullptr;		// unsigned char or float components, depending on pixelType
+		size_t residentSize = 0;	// Bytes of the GL storage
+
+		// BCn mip chain, read from the texture cache or compressed after the decoding
+		TextureCache::CompressedImage compressed;
+
+		// Mip chain of the uncompressed pixels, built by the loading thread so the GL thread only uploads it
+		Mipmap::Chain mips;
+
+		GLint levelsCount = 1;
+		GLint streamedLevels = 0;	// Levels still to upload by the streamer, the smallest ones go first
+		bool hasStorage = false;	// Immutable storage of all the levels, the streamed textures allocate them one by one
+
+		// Levels copied in the upload ring by the loading thread, and their offset in its slice
+		UploadSlice upload;
+		std::vector<size_t> uploadOffsets;
+
+		// Bytes of the GL storage of all the textures
+		static std::atomic<size_t> totalResidentSize;
+
+		// Texture of the same file content loaded from another path, drawn in place of this one
+		std::shared_ptr<Texture> source = nullptr;
+
+		// Textures drawn with this one, they are drawable with it
+		std::vector<std::weak_ptr<Texture>> aliases;
+		std::atomic_flag lockAliases = ATOMIC_FLAG_INIT;
+		bool isLoadEnded = false;
+
+		void aliasTo(const std::shared_ptr<Texture>& texture);
+		void releaseAliases();
+
+		// Share the texture already loaded from the same bytes (hash of the image file), false if this one is the first
+		bool findSameContent(const std::string& filePath, uint64_t contentHash, size_t fileSize);
+
+		void createID();
+		void uploadLevel(GLint level);
+		void setResidentLevels(GLint baseLevel);
+		void setDrawable();
+		void freeLevels();
+
+		size_t getLevelResidentSize(GLint level) const;
+
+		// Level in the memory of the loading thread
+		const void* getLevelPixels(GLint level) const;
+		size_t getLevelSize(GLint level) const;
+
+		// Copy all the levels in a slice of the upload ring, they stay in the client memory if it is full
+		void stageLevels();
+
+		// Upload the next (bigger) level, the texture is drawable from the smallest one
+		void streamNextLevel();
+
 		void generateID();
 		bool load(const std::string& filePath);
 
+		// Decode the image, and write its block compressed cache when used (read before by create)
+		bool loadCompressed(const std::string& filePath, bool useCache, uint64_t contentHash);
+
 	public:
 		Texture() = default;
 		~Texture();
 
-		bool isDrawable = false;
+		// Set by the GL thread, or by the loading thread of an alias
+		std::atomic<bool> isDrawable{ false };
+
+		// Loadings waiting for the upload of this texture
+		LoadWaiters loadWaiters;
 
 		GLuint getID() const;
 
 		void generate();
 		void bind(int textureIndex) const;
-		void create(const std::string& filePath, bool isMulti);
+		void create(const std::string& filePath, bool isMulti, bool useCache = false, bool isStreamed = false);
 		void set(const std::string& filePath, int width, int height, float* colorBuffer);
 
+		size_t getResidentSize() const;
+		static size_t getTotalResidentSize();
+
 		static std::shared_ptr<Texture> defaultAlpha;
 		static std::shared_ptr<Texture> defaultAmbient;
 		static std::shared_ptr<Texture> defaultDiffuse;
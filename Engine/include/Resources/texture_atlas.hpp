@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+
+#include <glad/glad.h>
+
+#include "singleton.hpp"
+#include "load_handle.hpp"
+#include "maths.hpp"
+
+#define ATLAS_PAGE_SIZE 2048
+#define ATLAS_MAX_IMAGE_SIZE 512	// Bigger images keep their own texture
+#define ATLAS_PADDING 1				// Border pixels repeated around each image, so the filtering does not read the neighbours
+
+namespace Resources
+{
+	// Place of an image in a page of the atlas, drawable once its pixels are uploaded
+	struct AtlasRegion
+	{
+		std::string imagePath;
+		int page = 0;
+		Core::Maths::vec4 uvRect = { 0.f, 0.f, 1.f, 1.f };	// Offset (xy) and scale (zw) of the UVs in the page
+
+		bool isDrawable = false;
+
+		// Loadings waiting for the upload of this region
+		LoadWaiters loadWaiters;
+	};
+
+	// Shared RGBA pages where the small images of the sprites are packed at load time (stb_rect_pack skyline),
+	// so the sprite pass binds one texture for all of them
+	class TextureAtlas final : public Singleton<TextureAtlas>
+	{
+		friend Singleton<TextureAtlas>;
+
+	private:
+		struct Page;
+
+		TextureAtlas() = default;
+		~TextureAtlas();
+
+		std::vector<std::unique_ptr<Page>> pages;
+		std::atomic_flag lockPages = ATOMIC_FLAG_INIT;
+
+		// GL thread
+		void uploadRegion(std::shared_ptr<AtlasRegion> region, Page* page, int x, int y, int width, int height);
+
+	public:
+		// Images small enough to share a page, only their header is read
+		static bool fits(const std::string& filePath);
+
+		// Decode the image and pack it in a page, its upload goes through the Graph requests when isOnRequest
+		static void add(const std::shared_ptr<AtlasRegion>& region, const std::string& filePath, bool isOnRequest);
+
+		// 0 until the first region of the page is uploaded
+		static GLuint getPageID(int page);
+		static size_t getPagesCount();
+	};
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+
+#include "bc_encoder.hpp"
+#include "mapped_file.hpp"
+
+// Increase when the texture cache layout or the encoder change
+#define TEXTURE_CACHE_VERSION 3
+
+// Largest level 0 side accepted from a cache file
+#define TEXTURE_CACHE_MAX_SIZE 65536
+
+namespace Utils
+{
+	class BinaryReader;
+}
+
+namespace Resources::TextureCache
+{
+	// One level of the mip chain, points in the file mapping or in the compressed data
+	struct Level
+	{
+		int width = 0;
+		int height = 0;
+		const unsigned char* data = nullptr;
+		size_t size = 0;
+	};
+
+	// Block compressed image with its full mip chain
+	struct CompressedImage
+	{
+		BC::Format format = BC::Format::BC1;
+		int channels = 4;	// Channels of the source image
+		uint64_t contentHash = 0;	// Of the source image file, finds the same contents without reading them
+		std::vector<Level> levels;
+
+		std::shared_ptr<Utils::MappedFile> file;	// When read from a cache
+		std::vector<unsigned char> data;			// When compressed in memory
+
+		size_t getSize() const;
+	};
+
+	// Path of the cache file of an image (same folder, .tex added to its name)
+	std::string getCachePath(const std::string& imagePath);
+
+	// Map the cache of the image, fail if missing, of another version, or if the image changed since
+	bool read(const std::string& imagePath, CompressedImage& image);
+
+	// Read a mip chain of a cache file, fail if its count or its sizes are not the ones of a halving chain
+	bool readLevels(Utils::BinaryReader& reader, BC::Format format, std::vector<Level>& levels);
+
+	// Write the cache of the image, keyed on the image size and last write time (its content hash is computed if not set)
+	bool write(const std::string& imagePath, const CompressedImage& image);
+
+	// Build the mip chain of an 8 bits image (sRGB correct Kaiser filter) and compress every level
+	void compress(const unsigned char* pixels, int width, int height, int channels, CompressedImage& image);
+
+	// Same in a given format, for images whose alpha is not used (cube map faces)
+	void compress(const unsigned char* pixels, int width, int height, int channels, BC::Format format, CompressedImage& image);
+}
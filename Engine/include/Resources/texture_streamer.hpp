@@ -0,0 +1,69 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <atomic>
+
+#include "singleton.hpp"
+#include "texture.hpp"
+
+#define TEXTURE_STREAMING_FRAME_BUDGET	(4 * 1024 * 1024)
+#define TEXTURE_STREAMING_RESIDENCY_CAP	(512 * 1024 * 1024)
+
+namespace Resources
+{
+	// Uploads the streamed textures level by level on the GL thread, the smallest levels of all the textures first
+	// so each one gets a low res placeholder before any is refined. Each frame uploads up to a bytes budget, and the
+	// textures stop being refined once all the textures resident on the GPU reach the residency cap
+	class TextureStreamer final : public Singleton<TextureStreamer>
+	{
+		friend Singleton<TextureStreamer>;
+
+	private:
+		TextureStreamer() = default;
+		~TextureStreamer() = default;
+
+		struct Entry
+		{
+			size_t nextLevelSize = 0;
+			std::weak_ptr<Texture> texture;
+		};
+
+		// Min heap on the size of the next level
+		std::vector<Entry> queue;
+
+		// Textures given by the loading threads, moved in the queue by the GL thread
+		std::vector<std::shared_ptr<Texture>> added;
+		std::atomic_flag lockAdded = ATOMIC_FLAG_INIT;
+
+		bool isEnabled = false;
+		size_t frameBudget = TEXTURE_STREAMING_FRAME_BUDGET;
+		size_t residencyCap = TEXTURE_STREAMING_RESIDENCY_CAP;
+
+		std::atomic<size_t> streamedBytes{ 0 };
+
+		static bool isBigger(const Entry& lhs, const Entry& rhs);
+
+		void push(const std::shared_ptr<Texture>& texture);
+
+	public:
+		// Any thread, once the levels of the texture are ready
+		static void add(const std::shared_ptr<Texture>& texture);
+
+		// GL thread, once per frame
+		static void update();
+
+		static void setEnabled(bool isEnabled);
+		static bool isStreamingEnabled();
+
+		static void setFrameBudget(size_t bytes);
+		static size_t getFrameBudget();
+
+		static void setResidencyCap(size_t bytes);
+		static size_t getResidencyCap();
+
+		// Textures waiting for a level, and bytes uploaded since the start
+		static size_t getPendingCount();
+		static size_t getStreamedBytes();
+	};
+}
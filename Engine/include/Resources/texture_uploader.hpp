@@ -0,0 +1,106 @@
+#pragma once
+
+#include <deque>
+#include <atomic>
+#include <cstdint>
+
+#include <glad/glad.h>
+
+#include "singleton.hpp"
+
+#define TEXTURE_UPLOAD_RING_SIZE		(64 * 1024 * 1024)
+#define TEXTURE_UPLOAD_ALIGNMENT		256
+
+namespace Resources
+{
+	// Part of the upload ring reserved by a loading thread, 0 id when there is none
+	struct UploadSlice
+	{
+		uint64_t id = 0;
+		unsigned char* data = nullptr;	// Mapped memory, written by the loading thread
+		size_t offset = 0;				// Offset in the pixel unpack buffer, given to the GL copies
+
+		bool isValid() const { return id != 0; }
+	};
+
+	// Ring of pixel unpack buffer persistently mapped. The loading threads copy their levels in a slice of it, so the GL thread only
+	// issues the copies from the buffer to the textures, done by the GPU without stalling the frame. The slices of a frame are fenced
+	// and the ring space comes back once the GPU read them; a full ring makes the reservation fail (upload from the client memory)
+	class TextureUploader final : public Singleton<TextureUploader>
+	{
+		friend Singleton<TextureUploader>;
+
+	private:
+		TextureUploader() = default;
+		~TextureUploader();
+
+		enum class SliceState
+		{
+			RESERVED,
+			SUBMITTED,
+			RELEASED
+		};
+
+		struct Slice
+		{
+			uint64_t end = 0;
+			SliceState state = SliceState::RESERVED;
+			uint64_t frame = 0;	// Frame of the submission
+		};
+
+		struct Fence
+		{
+			GLsync sync = nullptr;
+			uint64_t frame = 0;
+		};
+
+		GLuint bufferID = 0;
+		unsigned char* mapping = nullptr;
+
+		// Positions in the ring bytes since the start, the ring offset is the position modulo its size
+		uint64_t head = 0;
+		uint64_t tail = 0;
+
+		// Slices in the ring order, the first one has the id firstSliceID
+		std::deque<Slice> slices;
+		uint64_t firstSliceID = 1;
+		std::atomic_flag lockSlices = ATOMIC_FLAG_INIT;
+
+		// GL thread only
+		std::deque<Fence> fences;
+		uint64_t frame = 0;
+		uint64_t completedFrame = 0;
+		bool hasSubmitted = false;
+
+		std::atomic<size_t> uploadedBytes{ 0 };
+		std::atomic<size_t> fallbacksCount{ 0 };
+
+		Slice& getSlice(uint64_t id);
+
+		// Move the tail over the slices read by the GPU or released
+		void recycle();
+
+	public:
+		// GL thread, before any texture loading
+		static void init();
+
+		// Any thread, false if the ring has no room left (or is not initialized)
+		static bool reserve(size_t size, UploadSlice& slice);
+
+		// Any thread, for a slice that will not be submitted
+		static void release(UploadSlice& slice);
+
+		// GL thread, bind the ring as the pixel unpack buffer before the copies from the slice
+		static void bind();
+
+		// GL thread, after the copies from the slice: unbind the ring, the slice is fenced at the end of the frame
+		static void submit(UploadSlice& slice);
+
+		// GL thread, once per frame
+		static void update();
+
+		static size_t getUploadedBytes();
+		static size_t getFallbacksCount();
+		static size_t getUsedBytes();
+	};
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "maths.hpp"
+
+namespace Resources
+{
+	// Vertex formats of the meshes, chosen at load time
+	enum class VertexLayout : unsigned int
+	{
+		STANDARD,			// position float3, uv float2, normal float3 (32 bytes)
+		PACKED_NORMALS,		// position float3, uv half2, normal 10:10:10:2 (20 bytes)
+		OCTAHEDRAL_NORMALS	// position float3, uv half2, normal octahedral snorm16x2 (20 bytes)
+	};
+
+	namespace Vertex
+	{
+		unsigned int getSize(VertexLayout layout);
+		const char* getLayoutName(VertexLayout layout);
+
+		// Write one vertex in the given layout, vertex must have getSize(layout) bytes
+		void pack(VertexLayout layout, unsigned char* vertex, const Core::Maths::vec3& position, const Core::Maths::vec3& texCoords, const Core::Maths::vec3& normal);
+
+		unsigned short floatToHalf(float value);
+		unsigned int packNormal1010102(const Core::Maths::vec3& normal);
+		void packNormalOctahedral(const Core::Maths::vec3& normal, short* encoded);
+	}
+}
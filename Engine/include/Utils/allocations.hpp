@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Utils::Allocations
+{
+	// The global allocator is only replaced in the builds defining COUNT_ALLOCATIONS (benchmarks), the count stays 0 otherwise
+	bool isCounted();
+
+	// Calls of the global operator new since the start (containers, strings, shared_ptr, tasks too big for their buffer...).
+	// The difference between two calls counts the allocations of what ran in between, on every thread
+	size_t getCount();
+}
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <string>
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+#include <filesystem>
+
+namespace Utils
+{
+	// Sequential writer of the binary caches, counts the written bytes to align them
+	class BinaryWriter
+	{
+	private:
+		std::ofstream& m_stream;
+		size_t m_size = 0;
+
+	public:
+		BinaryWriter(std::ofstream& stream)
+			: m_stream(stream) {}
+
+		void bytes(const void* data, size_t size)
+		{
+			m_stream.write((const char*)data, size);
+			m_size += size;
+		}
+
+		template <typename T>
+		void value(T data)
+		{
+			bytes(&data, sizeof(T));
+		}
+
+		// Strings are padded so the next float blocks stay 4 bytes aligned
+		void string(const std::string& str)
+		{
+			value((uint32_t)str.size());
+			bytes(str.data(), str.size());
+			align();
+		}
+
+		void align()
+		{
+			static const char padding[4] = { 0 };
+			bytes(padding, (4 - m_size % 4) % 4);
+		}
+	};
+
+	// Bounds checked reader of a binary cache in memory, valid is false after any overflow
+	class BinaryReader
+	{
+	private:
+		const char* m_begin;
+		const char* m_cur;
+		const char* m_end;
+
+	public:
+		bool valid = true;
+
+		BinaryReader(const char* begin, const char* end)
+			: m_begin(begin), m_cur(begin), m_end(end) {}
+
+		const char* bytes(size_t size)
+		{
+			if (!valid || (size_t)(m_end - m_cur) < size)
+			{
+				valid = false;
+				return nullptr;
+			}
+
+			const char* data = m_cur;
+			m_cur += size;
+
+			return data;
+		}
+
+		template <typename T>
+		T value()
+		{
+			T data{};
+			if (const char* src = bytes(sizeof(T)))
+				memcpy(&data, src, sizeof(T));
+
+			return data;
+		}
+
+		// Count of the elements that follow, of minSize bytes each at least: invalid (0) if the rest can not hold them,
+		// a corrupt count never makes a huge resize
+		uint32_t count(size_t minSize)
+		{
+			uint32_t data = value<uint32_t>();
+			if (valid && (size_t)data > remaining() / (minSize > 0 ? minSize : 1))
+			{
+				valid = false;
+				return 0;
+			}
+
+			return data;
+		}
+
+		size_t remaining() const
+		{
+			return (size_t)(m_end - m_cur);
+		}
+
+		std::string string()
+		{
+			uint32_t size = value<uint32_t>();
+			const char* data = bytes(size);
+			align();
+
+			return data ? std::string(data, size) : std::string();
+		}
+
+		void align()
+		{
+			bytes((4 - (m_cur - m_begin) % 4) % 4);
+		}
+	};
+
+	// Key of a cache source file, the cache is outdated if one of them changed
+	inline bool getSourceKey(const std::string& filePath, uint64_t& size, int64_t& time)
+	{
+		std::error_code error;
+
+		size = (uint64_t)std::filesystem::file_size(filePath, error);
+		if (error)
+			return false;
+
+		time = (int64_t)std::filesystem::last_write_time(filePath, error).time_since_epoch().count();
+
+		return !error;
+	}
+
+	// Write a file through a temporary one so a reader never maps a partial file,
+	// writeContent returns false on failure
+	template <typename WriteContent>
+	bool writeAtomically(const std::string& filePath, WriteContent writeContent)
+	{
+		std::string tempPath = filePath + ".tmp";
+
+		std::error_code error;
+
+		{
+			std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+			if (!stream)
+			{
+				std::filesystem::remove(tempPath, error);
+				return false;
+			}
+
+			BinaryWriter writer(stream);
+			bool isWritten = writeContent(writer);
+
+			// Flushed by close, a full disk can fail there
+			stream.close();
+
+			if (!isWritten || !stream)
+			{
+				std::filesystem::remove(tempPath, error);
+				return false;
+			}
+		}
+
+		std::filesystem::rename(tempPath, filePath, error);
+
+		// Never leave the temp file behind
+		if (error)
+		{
+			std::filesystem::remove(tempPath, error);
+			return false;
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Utils
+{
+	// Fast non-cryptographic 64 bits hash of the bytes (xxHash64), to find identical contents
+	uint64_t hashBytes(const void* data, size_t size, uint64_t seed = 0);
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+
+#define IMAGE_POOL_MIN_BLOCK		256
+#define IMAGE_POOL_MAX_BLOCK		(256 * 1024 * 1024)	// Bigger buffers go straight to malloc
+#define IMAGE_POOL_THREAD_BYTES		(32 * 1024 * 1024)	// Free blocks kept by each thread
+#define IMAGE_POOL_SHARED_BYTES		(128 * 1024 * 1024)	// Free blocks kept for all the threads
+
+namespace Utils::ImagePool
+{
+	// Counters of the pool since the start (bytes are the block sizes, not the requested ones)
+	struct Stats
+	{
+		size_t liveBytes = 0;
+		size_t peakBytes = 0;
+		size_t pooledBytes = 0;		// Free blocks waiting in the caches
+		size_t allocationsCount = 0;
+		size_t reusedCount = 0;		// Allocations served by a cached block
+	};
+
+	// Image buffers (stb decoding scratch and pixels) in size classes of 4 steps per power of two. A freed block goes to the
+	// cache of its thread, then to a shared free list once the thread cache is full, so the loading threads of a scene reuse
+	// the buffers of the previous one instead of going through the global allocator
+	void* allocate(size_t size);
+	void* reallocate(void* pointer, size_t size);
+	void free(void* pointer);
+
+	Stats getStats();
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+
+namespace Utils
+{
+	// Read-only view of a whole file mapped in memory (no copy, no stream)
+	class MappedFile
+	{
+	private:
+		const char* m_data = nullptr;
+		size_t m_size = 0;
+
+#ifdef _WIN32
+		void* m_file = nullptr;
+		void* m_mapping = nullptr;
+#else
+		int m_file = -1;
+#endif
+
+	public:
+		MappedFile() = default;
+		MappedFile(const std::string& filePath);
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		// Map the file, return false if it can not be opened
+		bool open(const std::string& filePath);
+		void close();
+
+		bool isOpen() const;
+
+		const char* data() const;
+		const char* end() const;
+		size_t size() const;
+	};
+}
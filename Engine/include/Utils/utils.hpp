@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <cstdint>
 #include <functional>
 
 #include "maths.hpp"
@@ -57,6 +58,9 @@ namespace Utils
 
     std::string getTimeStrFromSeconds(float seconds);
 
+    // Return the peak resident memory of the process in bytes (0 if unknown)
+    size_t getPeakMemoryUsage();
+
     template <typename T>
     int sign(T value)
     {
@@ -1,6 +1,6 @@
 #version 450 core
 
-in vec3 TexCoord;
+in vec2 TexCoord;
 in vec3 Normal;
 in vec3 FragPos;
 
@@ -7,6 +7,9 @@ uniform vec4 color;
 
 uniform vec2 tilling;
 
+// Offset (xy) and scale (zw) of the image in its texture, a sub rectangle for the atlas pages
+uniform vec4 uvRect;
+
 out vec4 FragColor;
 
 vec2 getTilledTexCoords()
@@ -16,5 +19,6 @@ vec2 getTilledTexCoords()
 
 void main()
 {
-	FragColor = color * texture(diffuseTex, getTilledTexCoords());
+	// The tilling repeats inside the rectangle
+	FragColor = color * texture(diffuseTex, uvRect.xy + fract(getTilledTexCoords()) * uvRect.zw);
 }
\ No newline at end of file
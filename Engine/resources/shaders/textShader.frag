@@ -2,12 +2,12 @@
 
 out vec4 color;
 in  vec2 TexCoords;
+in  vec4 TextColor;
 
 uniform sampler2D text;
-uniform vec3 textColor;
 
 void main()
 {    
 	vec4 sampled = vec4(1.0, 1.0, 1.0, texture(text, TexCoords).r);
-	color = vec4(textColor, 1.0) * sampled;
-}
\ No newline at end of file
+	color = TextColor * sampled;
+}
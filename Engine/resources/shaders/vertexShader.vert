@@ -1,14 +1,27 @@
 #version 450 core
 layout (location = 0) in vec3 VertPos;
-layout (location = 1) in vec3 VertTexCoords;
+layout (location = 1) in vec2 VertTexCoords;
 layout (location = 2) in vec3 VertNormal;
+layout (location = 3) in vec2 VertOctNormal;
 
-out vec3 TexCoord;
+out vec2 TexCoord;
 out vec3 Normal;
 out vec3 FragPos;
 
 uniform mat4 viewProj;
 uniform mat4 model;
+uniform bool octNormals;	// Set by the layout of the mesh drawn
+
+// Octahedral normal decoding (unit square to unit sphere)
+vec3 octDecode(vec2 encoded)
+{
+	vec3 normal = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+	float fold = max(-normal.z, 0.0);
+	normal.x += normal.x >= 0.0 ? -fold : fold;
+	normal.y += normal.y >= 0.0 ? -fold : fold;
+
+	return normalize(normal);
+}
 
 void main()
 {
@@ -17,5 +30,8 @@ void main()
 	
 	TexCoord = VertTexCoords;
 
-	Normal = transpose(inverse(mat3(model))) * VertNormal;
-}
\ No newline at end of file
+	// Meshes with octahedral normals leave VertNormal disabled, the others VertOctNormal
+	vec3 vertNormal = octNormals ? octDecode(VertOctNormal) : VertNormal;
+
+	Normal = transpose(inverse(mat3(model))) * vertNormal;
+}
@@ -0,0 +1,366 @@
+#include <string>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <filesystem>
+
+#include "material_cache.hpp"
+#include "texture_cache.hpp"
+#include "vertex_layout.hpp"
+#include "mapped_file.hpp"
+#include "mesh_cache.hpp"
+#include "obj_parser.hpp"
+#include "mtl_parser.hpp"
+#include "mesh_data.hpp"
+
+#include "thread_pool.hpp"
+#include "allocations.hpp"
+#include "stb_image.h"
+#include "debug.hpp"
+
+// Headless converter: bakes every obj, mtl and image of a folder in the engine caches (.mesh, .mat and .tex),
+// no window and no GL context needed. Run from the project directory so the paths match the engine ones.
+//
+// Usage: Converter [folder = resources/obj] [--layout standard|packed|octahedral]
+//        Converter --pool-benchmark (task throughput of the thread pool from 1 worker to all the hardware threads)
+
+struct ConvertResult
+{
+	std::string filePath;
+	size_t sourceSize = 0;
+	size_t bakedSize = 0;
+	long long microseconds = 0;
+	bool succeeded = false;
+};
+
+static bool getLayout(const std::string& name, Resources::VertexLayout& layout)
+{
+	if (name == "standard")
+		layout = Resources::VertexLayout::STANDARD;
+	else if (name == "packed")
+		layout = Resources::VertexLayout::PACKED_NORMALS;
+	else if (name == "octahedral")
+		layout = Resources::VertexLayout::OCTAHEDRAL_NORMALS;
+	else
+		return false;
+
+	return true;
+}
+
+static size_t getFileSize(const std::string& filePath)
+{
+	std::error_code error;
+	size_t size = (size_t)std::filesystem::file_size(filePath, error);
+
+	return error ? 0 : size;
+}
+
+// Parse an obj with the engine parser and write its mesh cache, the groups are computed on all the workers
+static bool convertObj(const std::string& objPath, Resources::VertexLayout layout)
+{
+	namespace Obj = Resources::Obj;
+
+	Utils::MappedFile dataObj(objPath);
+	if (!dataObj.isOpen())
+	{
+		Core::Debug::Log::error("Unable to read the file : " + objPath);
+		return false;
+	}
+
+	Obj::Data data;
+
+	size_t chunksCount = std::min((size_t)ThreadPool::getThreadsCount(), dataObj.size() / OBJ_CHUNK_MIN_SIZE);
+
+	if (chunksCount > 1)
+	{
+		std::vector<Obj::Chunk> chunks = Obj::split(dataObj.data(), dataObj.end(), chunksCount);
+
+		ThreadPool::parallelFor(chunks.size(), [&](size_t i) { Obj::parseChunk(chunks[i]); });
+
+		Obj::prepareMerge(chunks, data);
+		ThreadPool::parallelFor(chunks.size(), [&](size_t i) { Obj::mergeChunk(chunks[i], data); });
+		Obj::mergeGroups(chunks, data);
+	}
+	else
+		Obj::parse(dataObj.data(), dataObj.end(), data);
+
+	std::vector<Resources::MeshData> meshes(data.groups.size());
+
+	ThreadPool::parallelFor(data.groups.size(), [&](size_t i)
+	{
+		const Obj::Group& group = data.groups[i];
+		meshes[i].compute(data.vertices, data.texCoords, data.normals, data.indices.data() + group.indicesBegin, group.indicesEnd - group.indicesBegin, layout);
+	});
+
+	std::vector<Resources::MeshCache::SubMesh> subMeshes;
+	for (size_t i = 0; i < meshes.size(); i++)
+	{
+		const Resources::MeshData& mesh = meshes[i];
+
+		subMeshes.push_back({ data.groups[i].name, data.groups[i].matName, mesh.verticesCount, mesh.indicesCount, mesh.sourceVerticesCount,
+			mesh.indexSize, mesh.attributs.data(), mesh.attributs.size(), mesh.indices.data() });
+	}
+
+	if (!Resources::MeshCache::write(objPath, layout, data.mtlLibs, subMeshes))
+	{
+		Core::Debug::Log::error("Unable to write the mesh cache of " + objPath);
+		return false;
+	}
+
+	return true;
+}
+
+static bool convertMtl(const std::string& mtlPath)
+{
+	std::ifstream dataMat(mtlPath);
+	if (!dataMat)
+	{
+		Core::Debug::Log::error("Unable to read the file: " + mtlPath);
+		return false;
+	}
+
+	if (!Resources::MaterialCache::write(mtlPath, Resources::Mtl::parse(dataMat)))
+	{
+		Core::Debug::Log::error("Unable to write the material cache of " + mtlPath);
+		return false;
+	}
+
+	return true;
+}
+
+static bool isImage(std::string extension)
+{
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return (char)tolower(c); });
+
+	return extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".tga" || extension == ".bmp";
+}
+
+// Decode an image as the engine does and write its block compressed cache
+static bool convertImage(const std::string& imagePath)
+{
+	stbi_set_flip_vertically_on_load_thread(true);
+
+	int width = 0, height = 0, channels = 0;
+	unsigned char* pixels = stbi_load(imagePath.c_str(), &width, &height, &channels, 0);
+	if (!pixels)
+	{
+		Core::Debug::Log::error(std::string(stbi_failure_reason()) + " " + imagePath);
+		return false;
+	}
+
+	Resources::TextureCache::CompressedImage image;
+	Resources::TextureCache::compress(pixels, width, height, channels, image);
+	stbi_image_free(pixels);
+
+	if (!Resources::TextureCache::write(imagePath, image))
+	{
+		Core::Debug::Log::error("Unable to write the texture cache of " + imagePath);
+		return false;
+	}
+
+	return true;
+}
+
+// Wait for the counter while the workers run the tasks
+static void waitTasks(const std::atomic<size_t>& done, size_t count)
+{
+	while (done.load() < count)
+		std::this_thread::yield();
+}
+
+// Throughput of tiny tasks, added by the main thread (injection queue) then spawned by tasks (worker deques)
+static void benchmarkThreadPool()
+{
+	const size_t tasksCount = 1 << 20;
+	const size_t rootsCount = 256;
+
+	unsigned int maxThreadsCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+	for (unsigned int threadsCount = 1; ; threadsCount = std::min(threadsCount * 2, maxThreadsCount))
+	{
+		ThreadPool::init(threadsCount);
+
+		std::atomic<size_t> done{ 0 };
+
+		size_t startAllocations = Utils::Allocations::getCount();
+
+		auto start = std::chrono::steady_clock::now();
+
+		for (size_t i = 0; i < tasksCount; i++)
+			ThreadPool::addTask([&done]() { done.fetch_add(1, std::memory_order_relaxed); });
+
+		waitTasks(done, tasksCount);
+
+		auto injectedEnd = std::chrono::steady_clock::now();
+
+		done.store(0);
+
+		for (size_t i = 0; i < rootsCount; i++)
+		{
+			ThreadPool::addTask([&done, tasksCount, rootsCount]()
+			{
+				for (size_t j = 0; j < tasksCount / rootsCount; j++)
+					ThreadPool::addTask([&done]() { done.fetch_add(1, std::memory_order_relaxed); });
+			});
+		}
+
+		waitTasks(done, tasksCount);
+
+		auto spawnedEnd = std::chrono::steady_clock::now();
+
+		// Task slots once, then none per task
+		double allocationsPerTask = (double)(Utils::Allocations::getCount() - startAllocations) / (double)(2 * tasksCount);
+
+		// Tasks far apart, the workers park between them and are woken by addTask
+		const size_t sparseCount = 200;
+
+		done.store(0);
+
+		for (size_t i = 0; i < sparseCount; i++)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			ThreadPool::addTask([&done]() { done.fetch_add(1, std::memory_order_relaxed); });
+		}
+
+		waitTasks(done, sparseCount);
+
+		ThreadPool::Stats stats = ThreadPool::getStats();
+
+		ThreadPool::end();
+		ThreadPool::kill();
+
+		double injectedSeconds = std::chrono::duration<double>(injectedEnd - start).count();
+		double spawnedSeconds = std::chrono::duration<double>(spawnedEnd - injectedEnd).count();
+
+		std::cout << threadsCount << " threads: " << tasksCount / injectedSeconds / 1000000.0 << " M tasks/s added from outside, "
+			<< tasksCount / spawnedSeconds / 1000000.0 << " M tasks/s spawned by tasks, " << stats.wakeupsCount << " wakeups ("
+			<< stats.averageWakeLatency << " us average latency, " << stats.maxWakeLatency << " us max), idle "
+			<< stats.spinningTime << " s searching / " << stats.parkedTime << " s parked, ";
+
+		if (Utils::Allocations::isCounted())
+			std::cout << allocationsPerTask << " allocations per task (";
+		else
+			std::cout << "allocations not counted (";
+
+		std::cout << stats.slotsCount << " task slots)" << std::endl;
+
+		if (threadsCount == maxThreadsCount)
+			break;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::string folder = "resources/obj";
+	Resources::VertexLayout layout = Resources::VertexLayout::PACKED_NORMALS;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+
+		if (arg == "--pool-benchmark")
+		{
+			benchmarkThreadPool();
+			return 0;
+		}
+		else if (arg == "--layout" && i + 1 < argc)
+		{
+			if (!getLayout(argv[++i], layout))
+			{
+				std::cerr << "Unknown vertex layout " << argv[i] << " (standard, packed or octahedral)" << std::endl;
+				return 1;
+			}
+		}
+		else if (arg.size() > 1 && arg[0] == '-')
+		{
+			std::cerr << "Usage: " << argv[0] << " [folder = resources/obj] [--layout standard|packed|octahedral] | --pool-benchmark" << std::endl;
+			return 1;
+		}
+		else
+			folder = arg;
+	}
+
+	std::error_code error;
+	if (!std::filesystem::is_directory(folder, error))
+	{
+		Core::Debug::Log::error("Unable to find the folder " + folder);
+		return 1;
+	}
+
+	// Paths are written in the caches, keep them as the engine builds them (relative, with /)
+	std::vector<ConvertResult> results;
+	for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(folder, error))
+	{
+		std::string extension = entry.path().extension().string();
+		if (entry.is_regular_file() && (extension == ".obj" || extension == ".mtl" || isImage(extension)))
+			results.push_back({ entry.path().generic_string() });
+	}
+
+	// Biggest files first so a huge obj does not start last
+	for (ConvertResult& result : results)
+		result.sourceSize = getFileSize(result.filePath);
+
+	std::sort(results.begin(), results.end(), [](const ConvertResult& lhs, const ConvertResult& rhs) { return lhs.sourceSize > rhs.sourceSize; });
+
+	ThreadPool::init();
+
+	auto start = std::chrono::steady_clock::now();
+
+	ThreadPool::parallelFor(results.size(), [&](size_t i)
+	{
+		ConvertResult& result = results[i];
+
+		auto fileStart = std::chrono::steady_clock::now();
+
+		std::string extension = std::filesystem::path(result.filePath).extension().string();
+
+		if (extension == ".obj")
+		{
+			result.succeeded = convertObj(result.filePath, layout);
+			result.bakedSize = getFileSize(Resources::MeshCache::getCachePath(result.filePath));
+		}
+		else if (isImage(extension))
+		{
+			result.succeeded = convertImage(result.filePath);
+			result.bakedSize = getFileSize(Resources::TextureCache::getCachePath(result.filePath));
+		}
+		else
+		{
+			result.succeeded = convertMtl(result.filePath);
+			result.bakedSize = getFileSize(Resources::MaterialCache::getCachePath(result.filePath));
+		}
+
+		auto fileEnd = std::chrono::steady_clock::now();
+		result.microseconds = std::chrono::duration_cast<std::chrono::microseconds>(fileEnd - fileStart).count();
+	});
+
+	auto end = std::chrono::steady_clock::now();
+	long long microseconds = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+	ThreadPool::end();
+
+	// Report, the throughput is the reproducible obj parsing benchmark
+	size_t sourceSize = 0, bakedSize = 0, failedCount = 0;
+	for (const ConvertResult& result : results)
+	{
+		std::cout << (result.succeeded ? "  " : "! ") << result.filePath << ": " << result.sourceSize / 1024 << " KB -> "
+			<< result.bakedSize / 1024 << " KB in " << result.microseconds / 1000.0 << " ms" << std::endl;
+
+		sourceSize += result.sourceSize;
+		bakedSize += result.bakedSize;
+		failedCount += result.succeeded ? 0 : 1;
+	}
+
+	float seconds = (float)microseconds / 1000000.f;
+	float megaBytes = (float)sourceSize / (1024.f * 1024.f);
+
+	std::cout << "Converted " << results.size() - failedCount << "/" << results.size() << " files (" << Resources::Vertex::getLayoutName(layout)
+		<< " layout) on " << ThreadPool::getThreadsCount() << " threads: " << megaBytes << " MB -> " << (float)bakedSize / (1024.f * 1024.f)
+		<< " MB in " << seconds << " s (" << (seconds > 0.f ? megaBytes / seconds : 0.f) << " MB/s)" << std::endl;
+
+	return failedCount == 0 ? 0 : 1;
+}
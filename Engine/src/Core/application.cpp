@@ -5,6 +5,8 @@
 #include <imgui_impl_opengl3.h>
 
 #include "resources_manager.hpp"
+#include "texture_streamer.hpp"
+#include "texture_uploader.hpp"
 #include "render_manager.hpp"
 #include "inputs_manager.hpp"
 #include "engine_master.hpp"
@@ -36,6 +38,9 @@ namespace Core
 		ThreadPool::kill();
 
 		Resources::ResourcesManager::kill();
+		Resources::TextureStreamer::kill();
+		Resources::TextureAtlas::kill();
+		Resources::TextureUploader::kill();
 
 		Debug::Log::info("Destroying the Application");
 
@@ -130,6 +135,7 @@ namespace Core
 		updateWindowSize(width, height);
 
 		// Init Managers
+		Resources::TextureUploader::init();
 		Resources::ResourcesManager::init();
 
 		ThreadPool::init();
@@ -34,7 +34,11 @@ namespace Core
 			std::time_t currentTime = std::time(0);	// Get current time
 
 			char timeString[26];
+#ifdef _WIN32
 			ctime_s(timeString, sizeof(timeString), &currentTime);
+#else
+			ctime_r(&currentTime, timeString);
+#endif
 			timeString[24] = '\0';
 
 			// Set the current log format
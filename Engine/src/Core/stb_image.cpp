@@ -1,3 +1,10 @@
+#include "image_pool.hpp"
+
+// Decoding buffers and pixels come from the image pool, stbi_image_free gives them back
+#define STBI_MALLOC(size)			Utils::ImagePool::allocate(size)
+#define STBI_REALLOC(pointer, size)	Utils::ImagePool::reallocate(pointer, size)
+#define STBI_FREE(pointer)			Utils::ImagePool::free(pointer)
+
 #define STB_IMAGE_IMPLEMENTATION
 #define STBI_THREAD_LOCAL
 #include "stb_image.h"
@@ -0,0 +1,3 @@
+// Implementation of the engine (the copy of ImGui is static to imgui_draw.cpp)
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "imstb_rectpack.h"
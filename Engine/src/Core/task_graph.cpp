@@ -0,0 +1,332 @@
+#include "task_graph.hpp"
+
+#include <algorithm>
+
+namespace Core
+{
+	#pragma region ____TASK____
+
+	thread_local Task* Task::current = nullptr;
+
+	Task::Task(const std::shared_ptr<TaskGroup>& group, const std::string& name, Function function, bool isMulti, bool isEvent)
+		: m_name(name), m_function(std::move(function)), m_isMulti(isMulti), m_isEvent(isEvent), m_priority(ThreadPool::getCurrentPriority()), m_group(group)
+	{}
+
+	void Task::after(const std::shared_ptr<Task>& predecessor)
+	{
+		if (!predecessor)
+			return;
+
+		predecessors.push_back(predecessor->id);
+
+		pendingCount.fetch_add(1);
+
+		while (predecessor->lock.test_and_set());
+
+		// Already ended, the submit count is still there so this never makes the task ready
+		if (predecessor->isEnded)
+		{
+			predecessor->lock.clear();
+			pendingCount.fetch_sub(1);
+			return;
+		}
+
+		predecessor->successors.push_back(shared_from_this());
+
+		predecessor->lock.clear();
+	}
+
+	void Task::submit()
+	{
+		if (isSubmitted.test_and_set())
+			return;
+
+		{
+			while (m_group->lockRecords.test_and_set());
+
+			TaskGroup::Record& record = m_group->getRecord(id);
+			record.predecessors = predecessors;
+			record.submitTime = TaskGroup::Clock::now();
+
+			// Ready from now: the running task decided it
+			if (current && current->m_group == m_group)
+				record.spawner = (long long)current->id;
+
+			m_group->lockRecords.clear();
+		}
+
+		arrive();
+	}
+
+	std::shared_ptr<Task> Task::then(const std::string& name, Function function, bool isMulti)
+	{
+		std::shared_ptr<Task> continuation = m_group->add(name, std::move(function), isMulti);
+		continuation->after(shared_from_this());
+		continuation->submit();
+
+		return continuation;
+	}
+
+	void Task::arrive()
+	{
+		if (pendingCount.fetch_sub(1) != 1)
+			return;
+
+		{
+			while (m_group->lockRecords.test_and_set());
+
+			m_group->getRecord(id).readyTime = TaskGroup::Clock::now();
+
+			m_group->lockRecords.clear();
+		}
+
+		if (m_isEvent)
+		{
+			while (lock.test_and_set());
+
+			isReady = true;
+			bool hasToFinish = isEndRequested;
+
+			lock.clear();
+
+			if (hasToFinish)
+				finish();
+		}
+		else if (m_isMulti)
+		{
+			std::shared_ptr<Task> self = shared_from_this();
+			ThreadPool::addTask([self]() { self->execute(); }, m_priority);
+		}
+		else
+			execute();
+	}
+
+	void Task::end()
+	{
+		if (!m_isEvent)
+			return;
+
+		while (lock.test_and_set());
+
+		// Ended once only, a resource can release its waiters several times
+		bool hasToFinish = isReady && !isEndRequested;
+		isEndRequested = true;
+
+		lock.clear();
+
+		if (hasToFinish)
+			finish();
+	}
+
+	void Task::execute()
+	{
+		{
+			while (m_group->lockRecords.test_and_set());
+
+			m_group->getRecord(id).startTime = TaskGroup::Clock::now();
+
+			m_group->lockRecords.clear();
+		}
+
+		// Nested when a task not on the pool runs inline
+		Task* previous = current;
+		current = this;
+
+		m_function();
+		m_function = nullptr;
+
+		current = previous;
+
+		finish();
+	}
+
+	void Task::finish()
+	{
+		{
+			while (m_group->lockRecords.test_and_set());
+
+			TaskGroup::Record& record = m_group->getRecord(id);
+			record.endTime = TaskGroup::Clock::now();
+
+			// An event runs from its ready time
+			if (m_isEvent)
+				record.startTime = record.readyTime;
+
+			m_group->lockRecords.clear();
+		}
+
+		while (lock.test_and_set());
+
+		isEnded = true;
+		std::vector<std::shared_ptr<Task>> ended = std::move(successors);
+		successors.clear();
+
+		lock.clear();
+
+		for (const std::shared_ptr<Task>& successor : ended)
+			successor->arrive();
+
+		// After the successors were counted by the group, so it is not done before them
+		m_group->endTask();
+	}
+
+	const std::string& Task::getName() const
+	{
+		return m_name;
+	}
+
+	#pragma endregion
+
+	#pragma region ____TASK_GROUP____
+
+	TaskGroup::TaskGroup(const std::string& name, const DoneCallback& onDone)
+		: m_name(name), m_onDone(onDone)
+	{
+		startTime = Clock::now();
+	}
+
+	TaskGroup::Record& TaskGroup::getRecord(size_t id)
+	{
+		return records[id];
+	}
+
+	std::shared_ptr<Task> TaskGroup::add(const std::string& name, Task::Function function, bool isMulti, bool isEvent)
+	{
+		std::shared_ptr<Task> task = std::make_shared<Task>(shared_from_this(), name, std::move(function), isMulti, isEvent);
+
+		pendingCount.fetch_add(1);
+
+		while (lockRecords.test_and_set());
+
+		task->id = records.size();
+		records.push_back(Record());
+		records.back().name = name;
+
+		lockRecords.clear();
+
+		return task;
+	}
+
+	std::shared_ptr<Task> TaskGroup::add(const std::string& name, Task::Function function, bool isMulti)
+	{
+		return add(name, std::move(function), isMulti, false);
+	}
+
+	std::shared_ptr<Task> TaskGroup::addEvent(const std::string& name)
+	{
+		return add(name, nullptr, false, true);
+	}
+
+	std::shared_ptr<Task> TaskGroup::run(const std::string& name, Task::Function function, bool isMulti)
+	{
+		std::shared_ptr<Task> task = add(name, std::move(function), isMulti);
+		task->submit();
+
+		return task;
+	}
+
+	void TaskGroup::endTask()
+	{
+		if (pendingCount.fetch_sub(1) != 1)
+			return;
+
+		// A task added once done does not complete it again
+		if (completedOnce.test_and_set())
+			return;
+
+		endTime = Clock::now();
+		isCompleted.store(true);
+
+		if (m_onDone)
+			m_onDone(*this);
+	}
+
+	bool TaskGroup::isDone() const
+	{
+		return isCompleted.load();
+	}
+
+	void TaskGroup::wait() const
+	{
+		ThreadPool::waitUntil([this]() { return isDone(); });
+	}
+
+	const std::string& TaskGroup::getName() const
+	{
+		return m_name;
+	}
+
+	size_t TaskGroup::getTasksCount()
+	{
+		while (lockRecords.test_and_set());
+
+		size_t count = records.size();
+
+		lockRecords.clear();
+
+		return count;
+	}
+
+	float TaskGroup::getTime() const
+	{
+		if (!isDone())
+			return 0.f;
+
+		return std::chrono::duration<float>(endTime - startTime).count();
+	}
+
+	std::vector<TaskGroup::Step> TaskGroup::getCriticalPath()
+	{
+		std::vector<Step> steps;
+
+		if (!isDone())
+			return steps;
+
+		while (lockRecords.test_and_set());
+
+		if (records.empty())
+		{
+			lockRecords.clear();
+			return steps;
+		}
+
+		size_t last = 0;
+		for (size_t i = 1; i < records.size(); i++)
+		{
+			if (records[i].endTime > records[last].endTime)
+				last = i;
+		}
+
+		// Back from the last task: the predecessor that ended last, or the spawner when it became ready after them
+		for (long long i = (long long)last; i >= 0 && steps.size() < records.size();)
+		{
+			const Record& record = records[(size_t)i];
+
+			Step step;
+			step.name = record.name;
+			step.waitTime = std::chrono::duration<float>(record.startTime - record.readyTime).count();
+			step.runTime = std::chrono::duration<float>(record.endTime - record.startTime).count();
+			steps.push_back(step);
+
+			long long cause = -1;
+			for (size_t predecessor : record.predecessors)
+			{
+				if (cause < 0 || records[predecessor].endTime > records[(size_t)cause].endTime)
+					cause = (long long)predecessor;
+			}
+
+			if (record.spawner >= 0 && (cause < 0 || record.submitTime > records[(size_t)cause].endTime))
+				cause = record.spawner;
+
+			i = cause;
+		}
+
+		lockRecords.clear();
+
+		std::reverse(steps.begin(), steps.end());
+
+		return steps;
+	}
+
+	#pragma endregion
+}
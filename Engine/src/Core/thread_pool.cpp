@@ -2,9 +2,26 @@
 
 #include <string>
 #include <sstream>
+#include <memory>
+#include <algorithm>
 
 #include "debug.hpp"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CPU_RELAX() _mm_pause()
+#else
+#define CPU_RELAX() std::this_thread::yield()
+#endif
+
+thread_local int ThreadPool::workerIndex = -1;
+thread_local TaskPriority ThreadPool::currentPriority = TaskPriority::NORMAL;
+
+static long long getNanoseconds(std::chrono::steady_clock::duration duration)
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+}
+
 ThreadPool::ThreadPool()
 {
 	Core::Debug::Log::info("Creating the Thread Pool");
@@ -12,23 +29,45 @@ ThreadPool::ThreadPool()
 
 ThreadPool::~ThreadPool()
 {
-	/*finish = true;
+	// Tasks never started
+	for (const std::unique_ptr<Worker>& worker : workers)
+	{
+		for (WorkDeque<TaskFunction>& deque : worker->deques)
+		{
+			while (TaskFunction* task = deque.steal())
+				delete task;
+		}
 
-	for (std::thread& thread : threads)
-		thread.join();*/
+		for (TaskFunction* slot : worker->freeSlots)
+			delete slot;
+	}
+
+	for (size_t lane = 0; lane < injected.size(); lane++)
+	{
+		for (size_t i = injectedFirst[lane]; i < injected[lane].size(); i++)
+			delete injected[lane][i];
+	}
+
+	for (TaskFunction* slot : freeSlots)
+		delete slot;
 }
 
 void ThreadPool::end()
 {
 	ThreadPool* TP = instance();
 
-	TP->finish = true;
+	TP->finish.store(true);
+
+	{
+		std::lock_guard<std::mutex> lock(TP->parkMutex);
+		TP->parkCondition.notify_all();
+	}
 
 	for (std::thread& thread : TP->threads)
 		thread.join();
 }
 
-void ThreadPool::init()
+void ThreadPool::init(unsigned int threadsCount)
 {
 	ThreadPool* TP = ThreadPool::instance();
 
@@ -42,45 +81,489 @@ void ThreadPool::init()
 
 	Core::Debug::Log::info("Initialize the Thread Pool");
 
-	TP->maxNumThreads = std::thread::hardware_concurrency();
+	TP->maxNumThreads = threadsCount > 0 ? threadsCount : std::max(std::thread::hardware_concurrency(), 1u);
+	TP->maxBackgroundCount = (int)TP->maxNumThreads - 1;
+
+	// All the deques exist before any worker can steal
+	for (unsigned int i = 0; i < TP->maxNumThreads; i++)
+	{
+		TP->workers.push_back(std::make_unique<Worker>());
+		TP->workers.back()->seed = 2654435761u * (i + 1);
+		TP->workers.back()->freeSlots.reserve(2 * POOL_TASKS_BATCH);
+	}
 
 	// Create permanent threads - Workers
 	for (unsigned int i = 0; i < TP->maxNumThreads; i++)
-		TP->threads.push_back(std::thread(&ThreadPool::threadRoutine, TP));
+		TP->threads.push_back(std::thread(&ThreadPool::threadRoutine, TP, (int)i));
 }
 
-bool ThreadPool::running()
+void ThreadPool::addTask(TaskFunction task)
 {
-	return instance()->count.load() > 0;
+	instance()->push(std::move(task), currentPriority);
 }
 
-bool ThreadPool::allowKill()
+void ThreadPool::addTask(TaskFunction task, TaskPriority priority)
 {
-	ThreadPool* TP = instance();
-	return TP->countEnd.load() == TP->maxNumThreads;
+	instance()->push(std::move(task), priority);
 }
 
-void ThreadPool::threadRoutine()
+void ThreadPool::allocateSlots()
 {
-	while (!finish)
+	for (size_t i = 0; i < POOL_TASKS_BATCH; i++)
+		freeSlots.push_back(new TaskFunction());
+
+	slotsCount.fetch_add(POOL_TASKS_BATCH);
+}
+
+TaskFunction* ThreadPool::takeSlot()
+{
+	// A worker reuses the slots of the tasks it ran, the shared ones are only locked once per batch
+	if (workerIndex >= 0)
 	{
-		// Routine, take a task and make it, or wait for another task
-		while (taskManager.test_and_set() && !finish)
-			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		std::vector<TaskFunction*>& slots = workers[workerIndex]->freeSlots;
 
-		if (tasks.empty())
+		if (slots.empty())
 		{
-			taskManager.clear();
+			while (lockSlots.test_and_set());
+
+			if (freeSlots.empty())
+				allocateSlots();
+
+			size_t batchCount = std::min(freeSlots.size(), (size_t)POOL_TASKS_BATCH);
+			slots.insert(slots.end(), freeSlots.end() - batchCount, freeSlots.end());
+			freeSlots.resize(freeSlots.size() - batchCount);
+
+			lockSlots.clear();
+		}
+
+		TaskFunction* slot = slots.back();
+		slots.pop_back();
+
+		return slot;
+	}
+
+	while (lockSlots.test_and_set());
+
+	if (freeSlots.empty())
+		allocateSlots();
+
+	TaskFunction* slot = freeSlots.back();
+	freeSlots.pop_back();
+
+	lockSlots.clear();
+
+	return slot;
+}
+
+void ThreadPool::releaseSlot(TaskFunction* slot)
+{
+	if (workerIndex >= 0)
+	{
+		std::vector<TaskFunction*>& slots = workers[workerIndex]->freeSlots;
+		slots.push_back(slot);
+
+		// Running the tasks added out of the pool, give a batch back to them
+		if (slots.size() < 2 * POOL_TASKS_BATCH)
+			return;
+
+		while (lockSlots.test_and_set());
+
+		if (freeSlots.size() < POOL_MAX_FREE_SLOTS)
+			freeSlots.insert(freeSlots.end(), slots.end() - POOL_TASKS_BATCH, slots.end());
+		else
+		{
+			// After a burst, only the slots of the usual tasks count are kept
+			for (auto it = slots.end() - POOL_TASKS_BATCH; it != slots.end(); it++)
+				delete *it;
+
+			slotsCount.fetch_sub(POOL_TASKS_BATCH);
+		}
+
+		slots.resize(slots.size() - POOL_TASKS_BATCH);
+
+		lockSlots.clear();
+
+		return;
+	}
+
+	while (lockSlots.test_and_set());
+
+	if (freeSlots.size() < POOL_MAX_FREE_SLOTS)
+		freeSlots.push_back(slot);
+	else
+	{
+		delete slot;
+		slotsCount.fetch_sub(1);
+	}
+
+	lockSlots.clear();
+}
+
+void ThreadPool::push(TaskFunction function, TaskPriority priority)
+{
+	count.fetch_add(1);
+
+	TaskFunction* task = takeSlot();
+	*task = std::move(function);
+
+	size_t lane = (size_t)priority;
+
+	// Spawned by a task: on the deque of its worker, no lock
+	if (workerIndex >= 0)
+		workers[workerIndex]->deques[lane].push(task);
+	else
+	{
+		while (lockInjected.test_and_set());
+
+		injected[lane].push_back(task);
+
+		lockInjected.clear();
+	}
+
+	// Pairs with the fence of park: either the parking worker sees the task, or the parked count is seen here
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	if (parkedCount.load() > 0)
+		wakeOne();
+}
+
+void ThreadPool::wakeOne()
+{
+	std::lock_guard<std::mutex> lock(parkMutex);
+
+	// The workers already woken will find this task too
+	if (parkedCount.load() <= wakeupsCount)
+		return;
+
+	wakeupsCount++;
+	wakeTimes.push_back(std::chrono::steady_clock::now());
+
+	parkCondition.notify_one();
+}
+
+bool ThreadPool::canRunBackground() const
+{
+	return maxBackgroundCount == 0 || backgroundCount.load() < maxBackgroundCount;
+}
+
+bool ThreadPool::hasTask()
+{
+	// The background tasks can not start while their workers are all taken, park until one ends
+	size_t lanesCount = canRunBackground() ? (size_t)TaskPriority::COUNT : (size_t)TaskPriority::BACKGROUND;
+
+	for (const std::unique_ptr<Worker>& worker : workers)
+	{
+		for (size_t lane = 0; lane < lanesCount; lane++)
+		{
+			if (!worker->deques[lane].empty())
+				return true;
+		}
+	}
+
+	while (lockInjected.test_and_set());
+
+	bool isEmpty = true;
+	for (size_t lane = 0; lane < lanesCount; lane++)
+		isEmpty = isEmpty && injected[lane].empty();
+
+	lockInjected.clear();
+
+	return !isEmpty;
+}
+
+TaskFunction* ThreadPool::waitTask(int index, TaskPriority& priority)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	TaskFunction* task = nullptr;
+
+	// Short waits between tasks do not pay the wake up
+	for (int i = 0; i < POOL_SPIN_COUNT + POOL_YIELD_COUNT && !finish.load(); i++)
+	{
+		task = findTask(index, priority);
+		if (task)
+			break;
+
+		if (i < POOL_SPIN_COUNT)
+			CPU_RELAX();
+		else
+			std::this_thread::yield();
+	}
+
+	// Only the searches ending without a task are wasted
+	if (!task)
+	{
+		spinningTime.fetch_add(getNanoseconds(std::chrono::steady_clock::now() - start));
+		park();
+	}
+
+	return task;
+}
+
+void ThreadPool::park()
+{
+	std::unique_lock<std::mutex> lock(parkMutex);
+
+	parkedCount.fetch_add(1);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	// Added between the last search and the count
+	if (hasTask() || finish.load())
+	{
+		parkedCount.fetch_sub(1);
+		return;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+
+	parkCondition.wait(lock, [this]() { return wakeupsCount > 0 || finish.load(); });
+
+	auto end = std::chrono::steady_clock::now();
+
+	parkedCount.fetch_sub(1);
+	parkedTime.fetch_add(getNanoseconds(end - start));
+
+	if (wakeupsCount == 0)
+		return;
+
+	wakeupsCount--;
+
+	long long latency = getNanoseconds(end - wakeTimes.front());
+	wakeTimes.pop_front();
+
+	totalWakeups.fetch_add(1);
+	wakeLatency.fetch_add(latency);
+
+	long long maxLatency = maxWakeLatency.load();
+	while (latency > maxLatency && !maxWakeLatency.compare_exchange_weak(maxLatency, latency));
+}
+
+TaskFunction* ThreadPool::popInjected(size_t lane)
+{
+	while (lockInjected.test_and_set());
+
+	std::vector<TaskFunction*>& tasks = injected[lane];
+	size_t& first = injectedFirst[lane];
+
+	TaskFunction* task = nullptr;
+	if (first < tasks.size())
+	{
+		task = tasks[first++];
+
+		// Its capacity is kept for the next tasks
+		if (first == tasks.size())
+		{
+			tasks.clear();
+			first = 0;
+		}
+	}
+
+	lockInjected.clear();
+
+	return task;
+}
+
+TaskFunction* ThreadPool::steal(int thiefIndex, size_t lane)
+{
+	Worker& thief = *workers[thiefIndex];
+	size_t workersCount = workers.size();
+
+	// Xorshift, a different first victim each time spreads the thieves
+	thief.seed ^= thief.seed << 13;
+	thief.seed ^= thief.seed >> 17;
+	thief.seed ^= thief.seed << 5;
+
+	size_t first = thief.seed % workersCount;
+
+	for (size_t i = 0; i < workersCount; i++)
+	{
+		size_t victim = (first + i) % workersCount;
+		if ((int)victim == thiefIndex)
 			continue;
+
+		if (TaskFunction* task = workers[victim]->deques[lane].steal())
+			return task;
+	}
+
+	return nullptr;
+}
+
+TaskFunction* ThreadPool::findTask(int index, TaskPriority& priority)
+{
+	for (size_t lane = 0; lane < (size_t)TaskPriority::COUNT; lane++)
+	{
+		bool isBackground = lane == (size_t)TaskPriority::BACKGROUND;
+
+		// The last free workers are kept for the interactive lanes. Without a worker to spare, reached once the other lanes are empty
+		if (isBackground && backgroundCount.fetch_add(1) >= maxBackgroundCount && maxBackgroundCount > 0)
+		{
+			backgroundCount.fetch_sub(1);
+			return nullptr;
+		}
+
+		TaskFunction* task = workers[index]->deques[lane].pop();
+
+		if (!task)
+			task = popInjected(lane);
+
+		if (!task)
+			task = steal(index, lane);
+
+		if (task)
+		{
+			priority = (TaskPriority)lane;
+			return task;
+		}
+
+		if (isBackground)
+			backgroundCount.fetch_sub(1);
+	}
+
+	return nullptr;
+}
+
+void ThreadPool::run(TaskFunction* task, TaskPriority priority)
+{
+	// The tasks it adds inherit its lane
+	TaskPriority previous = currentPriority;
+	currentPriority = priority;
+
+	(*task)();
+
+	// Its captures are released before the slot is reused
+	*task = nullptr;
+	releaseSlot(task);
+
+	currentPriority = previous;
+
+	tasksCount[(size_t)priority].fetch_add(1);
+
+	// A worker parked while the background workers were all taken can start the next one
+	if (priority == TaskPriority::BACKGROUND)
+	{
+		backgroundCount.fetch_sub(1);
+
+		if (parkedCount.load() > 0)
+			wakeOne();
+	}
+
+	count.fetch_sub(1);
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& func)
+{
+	ThreadPool* TP = instance();
+
+	struct Job
+	{
+		std::atomic<size_t> next{ 0 };
+		std::atomic<size_t> done{ 0 };
+	};
+
+	std::shared_ptr<Job> job = std::make_shared<Job>();
+
+	// Take indices until there is none left (func is not used once all indices are taken)
+	auto work = [job, count, &func]()
+	{
+		for (size_t i = job->next.fetch_add(1); i < count; i = job->next.fetch_add(1))
+		{
+			func(i);
+			job->done.fetch_add(1);
 		}
+	};
+
+	size_t helpersCount = count > 0 ? std::min((size_t)TP->maxNumThreads, count - 1) : 0;
+	for (size_t i = 0; i < helpersCount; i++)
+		addTask(work);
+
+	// The calling thread works too, so it never waits for an index that is not started
+	work();
+
+	// A worker runs other tasks while the last indices end, its own deque may hold some of them
+	waitUntil([&job, count]() { return job->done.load() >= count; });
+}
+
+void ThreadPool::waitUntil(const std::function<bool()>& isDone)
+{
+	ThreadPool* TP = instance();
+
+	while (!isDone())
+	{
+		TaskPriority priority = TaskPriority::NORMAL;
+		TaskFunction* task = workerIndex >= 0 ? TP->findTask(workerIndex, priority) : nullptr;
+
+		if (task)
+			TP->run(task, priority);
+		else
+			std::this_thread::yield();
+	}
+}
+
+unsigned int ThreadPool::getThreadsCount()
+{
+	return instance()->maxNumThreads;
+}
+
+TaskPriority ThreadPool::getCurrentPriority()
+{
+	return currentPriority;
+}
 
-		std::function<void()> task = tasks.front();
-		tasks.pop();
-		taskManager.clear();
+ThreadPool::PriorityScope::PriorityScope(TaskPriority priority)
+	: previous(currentPriority)
+{
+	currentPriority = priority;
+}
+
+ThreadPool::PriorityScope::~PriorityScope()
+{
+	currentPriority = previous;
+}
+
+ThreadPool::Stats ThreadPool::getStats()
+{
+	ThreadPool* TP = instance();
 
-		task();
+	Stats stats;
+	stats.wakeupsCount = TP->totalWakeups.load();
+	stats.averageWakeLatency = stats.wakeupsCount > 0 ? (float)TP->wakeLatency.load() / stats.wakeupsCount / 1000.f : 0.f;
+	stats.maxWakeLatency = (float)TP->maxWakeLatency.load() / 1000.f;
+	stats.spinningTime = (float)TP->spinningTime.load() / 1000000000.f;
+	stats.parkedTime = (float)TP->parkedTime.load() / 1000000000.f;
 
-		count.fetch_sub(1);
+	for (size_t lane = 0; lane < stats.tasksCount.size(); lane++)
+		stats.tasksCount[lane] = TP->tasksCount[lane].load();
+
+	stats.slotsCount = TP->slotsCount.load();
+
+	return stats;
+}
+
+bool ThreadPool::running()
+{
+	return instance()->count.load() > 0;
+}
+
+bool ThreadPool::allowKill()
+{
+	ThreadPool* TP = instance();
+	return TP->countEnd.load() == TP->maxNumThreads;
+}
+
+void ThreadPool::threadRoutine(int index)
+{
+	workerIndex = index;
+
+	while (!finish.load())
+	{
+		// Routine, take a task and make it, or wait for another task
+		TaskPriority priority = TaskPriority::NORMAL;
+		TaskFunction* task = findTask(index, priority);
+		if (!task)
+			task = waitTask(index, priority);
+
+		if (task)
+			run(task, priority);
 	}
 
 	std::stringstream ss;
@@ -88,5 +571,6 @@ void ThreadPool::threadRoutine()
 
 	Core::Debug::Log::info("Thread " + ss.str() + " has finished");
 
+	workerIndex = -1;
 	countEnd.fetch_add(1);
-}
\ No newline at end of file
+}
@@ -63,6 +63,16 @@ namespace LowRenderer
 		return m_filePath;
 	}
 
+	void Model::setLoadHandle(const std::shared_ptr<Resources::LoadHandle>& loadHandle)
+	{
+		m_loadHandle = loadHandle;
+	}
+
+	std::shared_ptr<Resources::LoadHandle> Model::getLoadHandle() const
+	{
+		return m_loadHandle;
+	}
+
 	void Model::drawImGui()
 	{
 		ImGui::Text(m_filePath.c_str());
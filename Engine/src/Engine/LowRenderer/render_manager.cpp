@@ -1,5 +1,6 @@
 #include "render_manager.hpp"
 
+#include <cstddef>
 #include <algorithm>
 
 #include "time.hpp"
@@ -24,6 +25,13 @@ namespace LowRenderer
 		models.clear();
 		lights.clear();
 		sprites.clear();
+		texts.clear();
+
+		if (textVAO)
+		{
+			glDeleteVertexArrays(1, &textVAO);
+			glDeleteBuffers(1, &textVBO);
+		}
 
 		Core::Debug::Log::info("Destroying the Render Manager");
 	}
@@ -122,6 +130,10 @@ namespace LowRenderer
 	{
 		std::shared_ptr<Resources::ShaderProgram> program;
 
+		// Sprites of the same atlas page share one bind
+		GLuint textureID = 0;
+		glActiveTexture(GL_TEXTURE0);
+
 		glClear(GL_DEPTH_BUFFER_BIT);
 
 		// Draw renderers
@@ -138,16 +150,105 @@ namespace LowRenderer
 				program->bind();
 
 				getCurrentCamera()->sendViewOrthoToProgram(program);
+
+				int i = 0;
+				program->setUniform("diffuseTex", &i);
+			}
+
+			if (sprite->getTextureID() != textureID)
+			{
+				textureID = sprite->getTextureID();
+				glBindTexture(GL_TEXTURE_2D, textureID);
 			}
 
 			sprite->draw();
 		}
 
-		program->unbind();
+		if (program)
+			program->unbind();
+
+		drawTexts();
 
 		glDisable(GL_FRAMEBUFFER_SRGB);
 	}
 
+	void RenderManager::drawTexts()
+	{
+		if (texts.empty())
+			return;
+
+		if (!textVAO)
+		{
+			glGenVertexArrays(1, &textVAO);
+			glGenBuffers(1, &textVBO);
+
+			glBindVertexArray(textVAO);
+			glBindBuffer(GL_ARRAY_BUFFER, textVBO);
+
+			glEnableVertexAttribArray(0);
+			glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Resources::TextVertex), (void*)offsetof(Resources::TextVertex, position));
+			glEnableVertexAttribArray(1);
+			glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Resources::TextVertex), (void*)offsetof(Resources::TextVertex, color));
+		}
+		else
+		{
+			glBindVertexArray(textVAO);
+			glBindBuffer(GL_ARRAY_BUFFER, textVBO);
+		}
+
+		std::shared_ptr<Resources::ShaderProgram> program = texts[0]->getProgram();
+
+		program->bind();
+
+		getCurrentCamera()->sendViewOrthoToProgram(program);
+
+		int i = 0;
+		program->setUniform("text", &i);
+		glActiveTexture(GL_TEXTURE0);
+
+		// The texts are drawn over the scene, the glyphs edges are blended
+		glDisable(GL_DEPTH_TEST);
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+		// One draw call per font, so one for the whole frame in most scenes
+		std::vector<Resources::Font*> fonts;
+		for (const std::shared_ptr<Resources::Text>& text : texts)
+		{
+			Resources::Font* font = text->getFont().get();
+
+			if (text->isActive() && font->isDrawable && std::find(fonts.begin(), fonts.end(), font) == fonts.end())
+				fonts.push_back(font);
+		}
+
+		for (Resources::Font* font : fonts)
+		{
+			textVertices.clear();
+
+			for (const std::shared_ptr<Resources::Text>& text : texts)
+			{
+				if (text->isActive() && text->getFont().get() == font)
+					text->batch(textVertices);
+			}
+
+			if (textVertices.empty())
+				continue;
+
+			// Orphaned each time, the previous draw keeps its storage
+			glBufferData(GL_ARRAY_BUFFER, textVertices.size() * sizeof(Resources::TextVertex), textVertices.data(), GL_STREAM_DRAW);
+
+			glBindTexture(GL_TEXTURE_2D, font->getID());
+			glDrawArrays(GL_TRIANGLES, 0, (GLsizei)textVertices.size());
+		}
+
+		glDisable(GL_BLEND);
+		glEnable(GL_DEPTH_TEST);
+
+		glBindVertexArray(0);
+
+		program->unbind();
+	}
+
 	void drawSpriteBench(std::shared_ptr<Resources::ShaderProgram>& program, std::shared_ptr<Resources::Mesh>& mesh, std::shared_ptr<Resources::Texture>& texture, const Core::Maths::mat4& model)
 	{
 		Core::Maths::vec4 color = { 1.f, 1.f, 1.f, 1.f };
@@ -156,6 +257,7 @@ namespace LowRenderer
 		program->setUniform("color", color.e);
 
 		program->setUniform("tilling", Core::Maths::vec2(1.f, 1.f).e);
+		program->setUniform("uvRect", Core::Maths::vec4(0.f, 0.f, 1.f, 1.f).e);
 
 		int i = 0;
 		program->setUniform("diffuseTex", &i);
@@ -273,6 +375,12 @@ namespace LowRenderer
 		instance()->colliders.push_back(compToLink);
 	}
 
+	void RenderManager::linkComponent(const std::shared_ptr<Resources::Text>& compToLink)
+	{
+		// Insert text to render
+		instance()->texts.push_back(compToLink);
+	}
+
 	void RenderManager::removeComponent(SpriteRenderer* compToRemove)
 	{
 		RenderManager* RM = instance();
@@ -301,6 +409,20 @@ namespace LowRenderer
 		}
 	}
 
+	void RenderManager::removeComponent(Resources::Text* compToRemove)
+	{
+		RenderManager* RM = instance();
+
+		for (auto it = RM->texts.begin(); it != RM->texts.end(); it++)
+		{
+			if (it->get() == compToRemove)
+			{
+				RM->texts.erase(it);
+				break;
+			}
+		}
+	}
+
 	std::shared_ptr<Camera> RenderManager::getCurrentCamera()
 	{
 		RenderManager* RM = instance();
@@ -31,7 +31,7 @@ namespace LowRenderer
 	SpriteRenderer::SpriteRenderer(Engine::GameObject& gameObject, const std::string& shaderPromgramName, const std::string& texturePath, bool isMulti, const Core::Maths::vec2& tilling)
 		: SpriteRenderer(gameObject, std::shared_ptr<SpriteRenderer>(this), shaderPromgramName)
 	{
-		texture = texturePath == "" ? Resources::Texture::defaultDiffuse : Resources::ResourcesManager::loadTexture(texturePath, isMulti);
+		setTexture(texturePath, isMulti);
 		mesh = Resources::ResourcesManager::getMeshByName("plane");
 
 		tillingMultiplier = tilling.x;
@@ -45,14 +45,33 @@ namespace LowRenderer
 		LowRenderer::RenderManager::removeComponent(this);
 	}
 
+	void SpriteRenderer::setTexture(const std::string& texturePath, bool isMulti)
+	{
+		region = texturePath == "" ? nullptr : Resources::ResourcesManager::loadAtlasRegion(texturePath, isMulti);
+
+		if (region)
+			texture = nullptr;
+		else
+			texture = texturePath == "" ? Resources::Texture::defaultDiffuse : Resources::ResourcesManager::loadTexture(texturePath, isMulti);
+	}
+
 	std::string SpriteRenderer::getTexturePath()
 	{
-		return texture->getPath();
+		return region ? region->imagePath : texture->getPath();
+	}
+
+	GLuint SpriteRenderer::getTextureID() const
+	{
+		if (region)
+			return region->isDrawable ? Resources::TextureAtlas::getPageID(region->page) : 0;
+
+		return texture->getID();
 	}
 
 	void SpriteRenderer::draw() const
 	{
-		if (!mesh)
+		// The texture is bound by the sprite pass, once for all the sprites of an atlas page
+		if (!mesh || (region && !region->isDrawable))
 			return;
 
 		m_shaderProgram->setUniform("model", m_transform->getGlobalModel().e, 1, 1);
@@ -60,29 +79,28 @@ namespace LowRenderer
 
 		m_shaderProgram->setUniform("tilling", Core::Maths::vec2(tillingMultiplier, tillingOffset).e);
 
-		int i = 0;
-		m_shaderProgram->setUniform("diffuseTex", &i);
-
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, texture->getID());
+		Core::Maths::vec4 uvRect = region ? region->uvRect : Core::Maths::vec4(0.f, 0.f, 1.f, 1.f);
+		m_shaderProgram->setUniform("uvRect", uvRect.e);
 
 		mesh->draw();
 	}
 
 	void SpriteRenderer::drawImGui()
 	{
-		ImGui::PushID(texture->getID());
+		ImGui::PushID(this);
 
 		if (ImGui::TreeNode("Sprite renderer"))
 		{
-			std::string texStr = "Texture : " + texture->getPath();
+			std::string texStr = "Texture : " + getTexturePath() + (region ? " (atlas page " + std::to_string(region->page) + ")" : "");
 			const char* texText = (texStr).c_str();
 			ImGui::Text(texText);
 
 			ImGui::DragFloat("TillingMultiplier", &tillingMultiplier, 0.1f, 0.f, 200.f);
 			ImGui::DragFloat("TillingOffset", &tillingOffset, 0.01f, 0.f, 1.f);
 			ImGui::ColorEdit4("Color", m_color.e);
-			ImGui::Image((void*)(intptr_t)texture->getID(), { 128, 128 }, ImVec2(0, 1), ImVec2(1, 0));
+
+			Core::Maths::vec4 uvRect = region ? region->uvRect : Core::Maths::vec4(0.f, 0.f, 1.f, 1.f);
+			ImGui::Image((void*)(intptr_t)getTextureID(), { 128, 128 }, ImVec2(uvRect.x, uvRect.y + uvRect.w), ImVec2(uvRect.x + uvRect.z, uvRect.y));
 
 			Component::drawImGui();
 
@@ -94,7 +112,7 @@ namespace LowRenderer
 
 	std::string SpriteRenderer::toString() const
 	{
-		return "COMP SPRITERENDERER " +  m_shaderProgram->getName() + " " + texture->getPath() + " " + std::to_string(tillingMultiplier) + " " + std::to_string(tillingOffset);
+		return "COMP SPRITERENDERER " +  m_shaderProgram->getName() + " " + (region ? region->imagePath : texture->getPath()) + " " + std::to_string(tillingMultiplier) + " " + std::to_string(tillingOffset);
 	}
 
 	void SpriteRenderer::parseComponent(Engine::GameObject& gameObject, std::istringstream& iss, bool isMulti)
@@ -116,7 +134,7 @@ namespace LowRenderer
 		}
 
 		sprite->m_shaderProgram = Resources::ResourcesManager::loadShaderProgram(shaderProgramName);
-		sprite->texture = Resources::ResourcesManager::loadTexture(texturePath, isMulti);
+		sprite->setTexture(texturePath, isMulti);
 		sprite->tillingMultiplier = tilling.x;
 		sprite->tillingOffset = tilling.y;
 	}
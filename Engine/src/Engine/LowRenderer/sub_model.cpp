@@ -39,9 +39,16 @@ namespace LowRenderer
 			// Send model matrix to program
 			shaderProgram->setUniform("model", transform->getGlobalModel().e, 1, 1);
 
+			// Normals decoding of the mesh vertex layout
+			if (shaderProgram->hasUniform("octNormals"))
+			{
+				int octNormals = m_mesh->layout == Resources::VertexLayout::OCTAHEDRAL_NORMALS;
+				shaderProgram->setUniform("octNormals", &octNormals);
+			}
+
 			std::shared_ptr<Resources::Material> mat = Resources::Material::defaultMaterial;
 
-			if (m_material->isDrawable)
+			if (m_material->isDrawable.load(std::memory_order_acquire))
 				mat = m_material;
 
 			mat->sendToShader(shaderProgram);
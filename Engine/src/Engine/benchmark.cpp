@@ -3,6 +3,9 @@
 #include <fstream>
 
 #include "utils.hpp"
+#include "image_pool.hpp"
+#include "thread_pool.hpp"
+#include "allocations.hpp"
 
 namespace Core::Engine
 {
@@ -11,11 +14,50 @@ namespace Core::Engine
 		instance()->sceneTrianglesCount += count;
 	}
 
+	void Benchmark::addVerticesCount(long sourceCount, long count)
+	{
+		Benchmark* BM = instance();
+
+		BM->sceneSourceVerticesCount += sourceCount;
+		BM->sceneVerticesCount += count;
+	}
+
+	void Benchmark::setMeshVisible()
+	{
+		Benchmark* BM = instance();
+
+		if (BM->isFirstMeshVisible)
+			return;
+
+		BM->isFirstMeshVisible = true;
+		BM->firstVisibleTime = (float)(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - BM->startLoad).count()) / 1000000.f;
+	}
+
+	void Benchmark::setInteractive()
+	{
+		Benchmark* BM = instance();
+
+		BM->interactiveTime.store((float)(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - BM->startLoad).count()) / 1000000.f);
+	}
+
 	void Benchmark::addTexturesCount(long count)
 	{
 		instance()->sceneTexturesCount += count;
 	}
 
+	void Benchmark::addTexturesMemory(long long bytes)
+	{
+		instance()->texturesMemory.fetch_add(bytes);
+	}
+
+	void Benchmark::addTextureDeduplicated(long long fileBytes)
+	{
+		Benchmark* bench = instance();
+
+		bench->dedupTexturesCount.fetch_add(1);
+		bench->dedupTexturesBytes.fetch_add(fileBytes);
+	}
+
 	void Benchmark::addModelsCount(long count)
 	{
 		instance()->sceneModelsCount += count;
@@ -26,11 +68,144 @@ namespace Core::Engine
 		instance()->sceneObjectsCount += count;
 	}
 
+	void Benchmark::addObjParsing(bool isMapped, long long bytes, long long microseconds)
+	{
+		Benchmark* BM = instance();
+
+		if (isMapped)
+		{
+			BM->mappedParsedBytes.fetch_add(bytes);
+			BM->mappedParsingTime.fetch_add(microseconds);
+		}
+		else
+		{
+			BM->streamParsedBytes.fetch_add(bytes);
+			BM->streamParsingTime.fetch_add(microseconds);
+		}
+	}
+
+	void Benchmark::addMeshCacheLoading(long long bytes, long long microseconds)
+	{
+		Benchmark* BM = instance();
+
+		BM->meshCacheBytes.fetch_add(bytes);
+		BM->meshCacheTime.fetch_add(microseconds);
+	}
+
+	void Benchmark::addObjPreScan(long long microseconds)
+	{
+		instance()->streamPreScanTime.fetch_add(microseconds);
+	}
+
+	void Benchmark::addModelLoading(float seconds)
+	{
+		Benchmark* BM = instance();
+
+		long long microseconds = (long long)(seconds * 1000000.f);
+
+		BM->modelsLoadingTime.fetch_add(microseconds);
+		BM->modelsLoadedCount.fetch_add(1);
+
+		long long maxTime = BM->modelsLoadingMaxTime.load();
+		while (microseconds > maxTime && !BM->modelsLoadingMaxTime.compare_exchange_weak(maxTime, microseconds));
+	}
+
+	float getParsingSpeed(long long bytes, long long microseconds)
+	{
+		if (microseconds == 0)
+			return 0.f;
+
+		// Bytes per microsecond to MB per second
+		return (float)((double)bytes / (double)microseconds * 1000000.0 / (1024.0 * 1024.0));
+	}
+
+	float Benchmark::getStreamParsingSpeed()
+	{
+		return getParsingSpeed(streamParsedBytes.load(), streamParsingTime.load());
+	}
+
+	float Benchmark::getMappedParsingSpeed()
+	{
+		return getParsingSpeed(mappedParsedBytes.load(), mappedParsingTime.load());
+	}
+
+	float Benchmark::getMeshCacheSpeed()
+	{
+		return getParsingSpeed(meshCacheBytes.load(), meshCacheTime.load());
+	}
+
+	float Benchmark::getStreamPreScanTime()
+	{
+		return (float)streamPreScanTime.load() / 1000000.f;
+	}
+
+	float Benchmark::getModelLoadingTime()
+	{
+		long count = modelsLoadedCount.load();
+
+		return count > 0 ? (float)modelsLoadingTime.load() / (float)count / 1000000.f : 0.f;
+	}
+
+	float Benchmark::getModelLoadingMaxTime()
+	{
+		return (float)modelsLoadingMaxTime.load() / 1000000.f;
+	}
+
 	long Benchmark::getTrianglesCount()
 	{
 		return sceneTrianglesCount;
 	}
 
+	float Benchmark::getPeakMemoryUsage()
+	{
+		return (float)peakMemoryUsage / (1024.f * 1024.f);
+	}
+
+	size_t Benchmark::getAllocationsCount()
+	{
+		return sceneAllocationsCount;
+	}
+
+	size_t Benchmark::getHeapTasksCount()
+	{
+		return sceneHeapTasksCount;
+	}
+
+	float Benchmark::getTexturesMemory()
+	{
+		return (float)texturesMemory.load() / (1024.f * 1024.f);
+	}
+
+	long Benchmark::getDeduplicatedTexturesCount()
+	{
+		return dedupTexturesCount.load();
+	}
+
+	float Benchmark::getDeduplicatedTexturesMemory()
+	{
+		return (float)dedupTexturesBytes.load() / (1024.f * 1024.f);
+	}
+
+	float Benchmark::getFirstVisibleTime()
+	{
+		return firstVisibleTime;
+	}
+
+	float Benchmark::getInteractiveTime()
+	{
+		return interactiveTime.load();
+	}
+
+	long Benchmark::getVerticesCount()
+	{
+		return sceneVerticesCount;
+	}
+
+	long Benchmark::getSourceVerticesCount()
+	{
+		return sceneSourceVerticesCount;
+	}
+
 	long Benchmark::getTexturesCount()
 	{
 		return sceneTexturesCount;
@@ -61,18 +236,61 @@ namespace Core::Engine
 		return benchRatio;
 	}
 
+	void Benchmark::setSceneTasks(Core::TaskGroup& tasks)
+	{
+		Benchmark* BM = instance();
+
+		BM->sceneTasksCount = tasks.getTasksCount();
+		BM->criticalPath = tasks.getCriticalPath();
+	}
+
+	size_t Benchmark::getSceneTasksCount()
+	{
+		return sceneTasksCount;
+	}
+
+	const std::vector<Core::TaskGroup::Step>& Benchmark::getCriticalPath()
+	{
+		return criticalPath;
+	}
+
+	float Benchmark::getCriticalPathTime()
+	{
+		float time = 0.f;
+		for (const Core::TaskGroup::Step& step : criticalPath)
+			time += step.waitTime + step.runTime;
+
+		return time;
+	}
+
 	void Benchmark::reset()
 	{
 		sceneTrianglesCount = 0;
+		sceneVerticesCount	= 0;
+		sceneSourceVerticesCount = 0;
 		sceneModelsCount	= 0;
 		sceneTexturesCount	= 0;
 		sceneObjectsCount	= 0;
+
+		dedupTexturesCount.store(0);
+		dedupTexturesBytes.store(0);
 	}
 
 	void Benchmark::clear()
 	{
 		loadingTimesMono.clear();
 		loadingTimesMulti.clear();
+
+		streamParsedBytes.store(0);
+		streamParsingTime.store(0);
+		mappedParsedBytes.store(0);
+		mappedParsingTime.store(0);
+		meshCacheBytes.store(0);
+		meshCacheTime.store(0);
+		streamPreScanTime.store(0);
+		modelsLoadingTime.store(0);
+		modelsLoadingMaxTime.store(0);
+		modelsLoadedCount.store(0);
 	}
 	
 	bool Benchmark::isActive()
@@ -87,7 +305,15 @@ namespace Core::Engine
 
 	void Benchmark::startTimer()
 	{
-		instance()->startLoad = std::chrono::steady_clock::now();
+		Benchmark* BM = instance();
+
+		BM->startLoad = std::chrono::steady_clock::now();
+		BM->isFirstMeshVisible = false;
+		BM->firstVisibleTime = 0.f;
+		BM->interactiveTime.store(0.f);
+
+		BM->startAllocationsCount = Utils::Allocations::getCount();
+		BM->startHeapTasksCount = TaskFunction::getHeapCount();
 	}
 
 	void getAverageTime(std::vector<float>& times, float& averageTime, float curTime)
@@ -119,6 +345,11 @@ namespace Core::Engine
 			if (BM->averageTimeMulti != 0.f)
 				BM->benchRatio = BM->averageTimeMono / BM->averageTimeMulti;
 		}
+
+		BM->peakMemoryUsage = Utils::getPeakMemoryUsage();
+
+		BM->sceneAllocationsCount = Utils::Allocations::getCount() - BM->startAllocationsCount;
+		BM->sceneHeapTasksCount = TaskFunction::getHeapCount() - BM->startHeapTasksCount;
 	}
 
 	Benchmark* Benchmark::getInstance()
@@ -137,7 +368,50 @@ namespace Core::Engine
 		flux << "Scene objects count : " + std::to_string(sceneObjectsCount);
 		flux << " (for " + std::to_string(sceneModelsCount) + " models loaded)\n";
 		flux << "Scene triangles count : " + std::to_string(sceneTrianglesCount) + "\n";
-		flux << "Scene textures count : " + std::to_string(sceneTexturesCount) + "\n";
+		flux << "Scene vertices count : " + std::to_string(sceneVerticesCount);
+		flux << " (" + std::to_string(sceneSourceVerticesCount) + " before deduplication)\n";
+		flux << "Scene textures count : " + std::to_string(sceneTexturesCount);
+		flux << " (" + std::to_string(getTexturesMemory()) + " MB resident)\n";
+		flux << "Deduplicated textures : " + std::to_string(getDeduplicatedTexturesCount());
+		flux << " (" + std::to_string(getDeduplicatedTexturesMemory()) + " MB of identical files not loaded again)\n";
+		flux << "Peak memory usage : " + std::to_string(getPeakMemoryUsage()) + " MB\n";
+		if (Utils::Allocations::isCounted())
+			flux << "Allocations : " + std::to_string(sceneAllocationsCount) + " during the loading (";
+		else
+			flux << "Allocations : not counted (";
+		flux << std::to_string(sceneHeapTasksCount) + " tasks too big for their buffer)\n";
+		Utils::ImagePool::Stats imagePool = Utils::ImagePool::getStats();
+		flux << "Image decoding pool : " + std::to_string(imagePool.peakBytes / (1024 * 1024)) + " MB peak, ";
+		flux << std::to_string(imagePool.reusedCount) + "/" + std::to_string(imagePool.allocationsCount) + " buffers reused\n";
+		ThreadPool::Stats pool = ThreadPool::getStats();
+		flux << "Thread pool : " + std::to_string(pool.wakeupsCount) + " wakeups, " + std::to_string(pool.averageWakeLatency) + " us average latency (";
+		flux << std::to_string(pool.maxWakeLatency) + " us max), " + std::to_string(pool.spinningTime) + " sec searching, ";
+		flux << std::to_string(pool.parkedTime) + " sec parked, " + std::to_string(pool.tasksCount[(size_t)TaskPriority::CRITICAL]) + " critical / ";
+		flux << std::to_string(pool.tasksCount[(size_t)TaskPriority::NORMAL]) + " normal / ";
+		flux << std::to_string(pool.tasksCount[(size_t)TaskPriority::BACKGROUND]) + " background tasks, " + std::to_string(pool.slotsCount) + " task slots\n";
+		flux << "Time to first visible submesh : " + std::to_string(firstVisibleTime) + " sec\n";
+		flux << "Time to interactive : " + std::to_string(getInteractiveTime()) + " sec (critical objects loaded)\n";
+		flux << "Model loading latency : " + std::to_string(getModelLoadingTime()) + " sec average, ";
+		flux << std::to_string(getModelLoadingMaxTime()) + " sec max\n";
+
+		if (streamParsedBytes.load() > 0)
+			flux << "Stream obj parser : " + std::to_string(getStreamParsingSpeed()) + " MB/s (+ " + std::to_string(getStreamPreScanTime()) + " sec pre-scan)\n";
+		if (mappedParsedBytes.load() > 0)
+			flux << "Mapped obj parser : " + std::to_string(getMappedParsingSpeed()) + " MB/s\n";
+		if (meshCacheBytes.load() > 0)
+			flux << "Mesh cache : " + std::to_string(getMeshCacheSpeed()) + " MB/s\n";
+
+		if (!criticalPath.empty())
+		{
+			flux << "\nScene critical path : " + std::to_string(getCriticalPathTime()) + " sec over " + std::to_string(criticalPath.size());
+			flux << " of " + std::to_string(sceneTasksCount) + " tasks\n";
+
+			for (const Core::TaskGroup::Step& step : criticalPath)
+			{
+				flux << "    " + step.name + " : " + std::to_string(step.runTime) + " sec running, ";
+				flux << std::to_string(step.waitTime) + " sec waiting\n";
+			}
+		}
 
 		flux << "___________________________________________________________\n\n";
 
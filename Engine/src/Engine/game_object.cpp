@@ -8,6 +8,7 @@
 #include "resources_manager.hpp"
 
 #include "sprite_renderer.hpp"
+#include "character.hpp"
 #include "player_shooting.hpp"
 #include "player_movement.hpp"
 #include "camera_movement.hpp"
@@ -135,6 +136,9 @@ namespace Engine
 		if (m_recipe != "")
 			goParse += "RECIPE " + m_recipe + '\n';
 
+		if (m_loadPriority != "")
+			goParse += "PRIORITY " + m_loadPriority + '\n';
+
 		for (auto& comp : m_components)
 			goParse += comp->toString() + "\n";
 
@@ -231,6 +235,8 @@ namespace Engine
 			LowRenderer::SkyBox::parseComponent(*this, goStream, isMultiThreaded);
 		else if (comp == "SPRITERENDERER")
 			LowRenderer::SpriteRenderer::parseComponent(*this, goStream, isMultiThreaded);
+		else if (comp == "TEXT")
+			Resources::Text::parseComponent(*this, goStream, isMultiThreaded);
 		else if (comp == "PLAYERMOVEMENT")
 			Gameplay::PlayerMovement::parseComponent(*this, goStream);
 		else if (comp == "CAMERAMOVEMENT")
@@ -277,6 +283,8 @@ namespace Engine
 				iss >> filePath;
 				parseRecipe(filePath, parentName);
 			}
+			else if (type == "PRIORITY")
+				iss >> m_loadPriority;
 			else if (type == "endGO")
 				break;
 		}
@@ -1,13 +1,18 @@
 #include "graph.hpp"
 
 #include <fstream>
+#include <algorithm>
 
 #include "imgui.h"
 
 #include "resources_manager.hpp"
+#include "texture_streamer.hpp"
+#include "texture_uploader.hpp"
 #include "physic_manager.hpp"
 #include "engine_master.hpp"
 #include "thread_pool.hpp"
+#include "image_pool.hpp"
+#include "allocations.hpp"
 #include "application.hpp"
 #include "debug.hpp"
 #include "time.hpp"
@@ -34,10 +39,17 @@ namespace Core::Engine
 	{
 		curScene.clear();
 
-		if (onTask)
-			ThreadPool::addTask(std::bind(&Resources::Scene::load, &curScene, scenePath, isMultithreaded));
-		else
-			curScene.load(scenePath, isMultithreaded);
+		// Created before the loading starts, the benchmark only reads them from this thread
+		curScene.loadHandle = std::make_shared<Resources::LoadHandle>();
+		Resources::ResourcesManager::setSceneLoadHandle(curScene.loadHandle);
+
+		curScene.tasks = std::make_shared<Core::TaskGroup>("Scene " + scenePath);
+		Resources::ResourcesManager::setSceneTasks(curScene.tasks);
+
+		// The first task of the graph, the loadings are started by it
+		Resources::Scene* scene = &curScene;
+		bool isMulti = isMultithreaded;
+		curScene.tasks->run("Scene " + scenePath, [scene, scenePath, isMulti]() { scene->load(scenePath, isMulti); }, onTask);
 
 		Core::TimeManager::resetTime();
 	}
@@ -109,11 +121,13 @@ namespace Core::Engine
 			reload();
 		}
 
-		if (!ThreadPool::running() && requests.empty())
+		// The scene is loaded once every task of its graph ended, the last ones are the uploads
+		if (curScene.tasks && curScene.tasks->isDone())
 		{
 			if (!bench->timerEnd)
 			{
 				bench->endTimer(isMultithreaded);
+				Benchmark::setSceneTasks(*curScene.tasks);
 				bench->timerEnd = true;
 			}
 
@@ -143,6 +157,22 @@ namespace Core::Engine
 		}
 	}
 
+	void Graph::addRequest(TaskFunction request)
+	{
+		Graph* graph = instance();
+
+		if (graph == nullptr)
+			return;
+
+		size_t lane = (size_t)ThreadPool::getCurrentPriority();
+
+		while (graph->requestFlag.test_and_set());
+
+		graph->requests[lane].requests.push_back(std::move(request));
+
+		graph->requestFlag.clear();
+	}
+
 	void Graph::checkRequests()
 	{
 		Graph* graph = instance();
@@ -152,18 +182,29 @@ namespace Core::Engine
 		// Lock requests vector
 		while (graph->requestFlag.test_and_set());
 
-		for (int i = 0; i < MAX_REQUESTS_PER_FRAME; i++)
+		for (RequestsQueue& lane : graph->requests)
 		{
-			if (graph->requests.size() == 0)
-				break;
+			while (graph->dueRequests.size() < MAX_REQUESTS_PER_FRAME && lane.first < lane.requests.size())
+				graph->dueRequests.push_back(std::move(lane.requests[lane.first++]));
 
-			auto request = graph->requests.front();
-			request();
-			graph->requests.pop();
+			if (lane.first == lane.requests.size())
+			{
+				lane.requests.clear();
+				lane.first = 0;
+			}
 		}
 
-		// Unlock the vector
+		// Unlock the vector, the requests may add new ones
 		graph->requestFlag.clear();
+
+		for (TaskFunction& request : graph->dueRequests)
+			request();
+
+		// Their captures are released once they ran
+		graph->dueRequests.clear();
+
+		Resources::TextureStreamer::update();
+		Resources::TextureUploader::update();
 	}
 
 	void Graph::deleteGameObject(const std::string& goName)
@@ -192,10 +233,18 @@ namespace Core::Engine
 		}
 	}
 
+	bool Graph::isSceneLoaded() const
+	{
+		return !curScene.tasks || curScene.tasks->isDone();
+	}
+
 	void Graph::reload(const std::string& _sceneName)
 	{
-		while (!requests.empty())
-			requests.pop();
+		for (RequestsQueue& lane : requests)
+		{
+			lane.requests.clear();
+			lane.first = 0;
+		}
 
 		bench->reset();
 
@@ -208,7 +257,7 @@ namespace Core::Engine
 	{
 		static char bufferPathBench[512];
 
-		if (!ThreadPool::running())
+		if (isSceneLoaded())
 		{
 			ImGui::Text("Benchmark : Reload n time in multi and mono");
 			ImGui::InputInt("Reload count", &bench->benchmarkMaxReloadCount);
@@ -245,7 +294,60 @@ namespace Core::Engine
 		Utils::imGuiTextFromString("Objects count : " + std::to_string(bench->getObjectsCount())
 			+ " (for " + std::to_string(bench->getModelsCount()) + " models loaded)");
 		Utils::imGuiTextFromString("Triangles count : " + std::to_string(bench->getTrianglesCount()));
-		Utils::imGuiTextFromString("Textures count : " + std::to_string(bench->getTexturesCount()));
+		Utils::imGuiTextFromString("Vertices count : " + std::to_string(bench->getVerticesCount())
+			+ " (" + std::to_string(bench->getSourceVerticesCount()) + " before deduplication)");
+		Utils::imGuiTextFromString("Textures count : " + std::to_string(bench->getTexturesCount())
+			+ " (" + std::to_string(bench->getTexturesMemory()) + " MB resident)");
+		if (bench->getDeduplicatedTexturesCount() > 0)
+			Utils::imGuiTextFromString("Deduplicated textures : " + std::to_string(bench->getDeduplicatedTexturesCount())
+				+ " (" + std::to_string(bench->getDeduplicatedTexturesMemory()) + " MB of identical files not loaded again)");
+		if (Resources::TextureStreamer::getStreamedBytes() > 0)
+			Utils::imGuiTextFromString("Texture streaming : " + std::to_string(Resources::TextureStreamer::getPendingCount()) + " textures refining, "
+				+ std::to_string(Resources::TextureStreamer::getStreamedBytes() / (1024 * 1024)) + " MB streamed");
+		if (Resources::TextureUploader::getUploadedBytes() > 0)
+			Utils::imGuiTextFromString("Texture upload ring : " + std::to_string(Resources::TextureUploader::getUploadedBytes() / (1024 * 1024)) + " MB staged, "
+				+ std::to_string(Resources::TextureUploader::getUsedBytes() / (1024 * 1024)) + " MB in flight, "
+				+ std::to_string(Resources::TextureUploader::getFallbacksCount()) + " textures uploaded from the client memory");
+		Utils::ImagePool::Stats imagePool = Utils::ImagePool::getStats();
+		if (imagePool.allocationsCount > 0)
+			Utils::imGuiTextFromString("Image decoding pool : " + std::to_string(imagePool.liveBytes / (1024 * 1024)) + " MB live, "
+				+ std::to_string(imagePool.peakBytes / (1024 * 1024)) + " MB peak, " + std::to_string(imagePool.pooledBytes / (1024 * 1024))
+				+ " MB pooled, " + std::to_string(imagePool.reusedCount * 100 / imagePool.allocationsCount) + "% reused");
+		ThreadPool::Stats pool = ThreadPool::getStats();
+		Utils::imGuiTextFromString("Thread pool : " + std::to_string(pool.wakeupsCount) + " wakeups, "
+			+ std::to_string((int)pool.averageWakeLatency) + " us average latency (" + std::to_string((int)pool.maxWakeLatency) + " us max), idle "
+			+ std::to_string((int)pool.spinningTime) + " s searching / " + std::to_string((int)pool.parkedTime) + " s parked");
+		Utils::imGuiTextFromString("Thread pool lanes : " + std::to_string(pool.tasksCount[(size_t)TaskPriority::CRITICAL]) + " critical, "
+			+ std::to_string(pool.tasksCount[(size_t)TaskPriority::NORMAL]) + " normal, "
+			+ std::to_string(pool.tasksCount[(size_t)TaskPriority::BACKGROUND]) + " background tasks, " + std::to_string(pool.slotsCount) + " task slots");
+		Utils::imGuiTextFromString("Peak memory usage : " + std::to_string(bench->getPeakMemoryUsage()) + " MB");
+		std::string allocations = Utils::Allocations::isCounted() ? std::to_string(bench->getAllocationsCount()) + " during the loading" : "not counted";
+		Utils::imGuiTextFromString("Allocations : " + allocations + " (" + std::to_string(bench->getHeapTasksCount()) + " tasks too big for their buffer)");
+		Utils::imGuiTextFromString("Time to first visible submesh : " + std::to_string(bench->getFirstVisibleTime()) + " sec");
+		Utils::imGuiTextFromString("Time to interactive : " + std::to_string(bench->getInteractiveTime()) + " sec (critical objects loaded)");
+		Utils::imGuiTextFromString("Model loading latency : " + std::to_string(bench->getModelLoadingTime()) + " sec average, "
+			+ std::to_string(bench->getModelLoadingMaxTime()) + " sec max");
+
+		if (bench->getStreamParsingSpeed() > 0.f)
+			Utils::imGuiTextFromString("Stream obj parser : " + std::to_string(bench->getStreamParsingSpeed()) + " MB/s (+ "
+				+ std::to_string(bench->getStreamPreScanTime()) + " sec pre-scan)");
+		if (bench->getMappedParsingSpeed() > 0.f)
+			Utils::imGuiTextFromString("Mapped obj parser : " + std::to_string(bench->getMappedParsingSpeed()) + " MB/s");
+		if (bench->getMeshCacheSpeed() > 0.f)
+			Utils::imGuiTextFromString("Mesh cache : " + std::to_string(bench->getMeshCacheSpeed()) + " MB/s");
+
+		const std::vector<Core::TaskGroup::Step>& criticalPath = bench->getCriticalPath();
+		if (!criticalPath.empty() && ImGui::TreeNode("Scene critical path"))
+		{
+			Utils::imGuiTextFromString(std::to_string(bench->getCriticalPathTime()) + " sec over " + std::to_string(criticalPath.size())
+				+ " of " + std::to_string(bench->getSceneTasksCount()) + " tasks");
+
+			for (const Core::TaskGroup::Step& step : criticalPath)
+				Utils::imGuiTextFromString(step.name + " : " + std::to_string(step.runTime) + " sec running, "
+					+ std::to_string(step.waitTime) + " sec waiting");
+
+			ImGui::TreePop();
+		}
 
 		ImGui::Spacing();
 		ImGui::Spacing();
@@ -323,10 +425,49 @@ namespace Core::Engine
 				ImGui::Spacing();
 				ImGui::Spacing();
 
-				if (!ThreadPool::running())
+				if (graph->isSceneLoaded())
 				{
 					ImGui::Checkbox("MultiThread", &graph->isMultithreaded);
 
+					bool isMappedParser = Resources::ResourcesManager::getObjParser() == Resources::ObjParserType::MAPPED;
+					if (ImGui::Checkbox("Memory-mapped obj parser", &isMappedParser))
+						Resources::ResourcesManager::setObjParser(isMappedParser ? Resources::ObjParserType::MAPPED : Resources::ObjParserType::STREAM);
+
+					bool useMeshCache = Resources::ResourcesManager::isMeshCacheEnabled();
+					if (ImGui::Checkbox("Binary mesh cache (mapped parser)", &useMeshCache))
+						Resources::ResourcesManager::setMeshCache(useMeshCache);
+
+					bool useTextureCache = Resources::ResourcesManager::isTextureCacheEnabled();
+					if (ImGui::Checkbox("Compressed texture cache (BCn + mips)", &useTextureCache))
+						Resources::ResourcesManager::setTextureCache(useTextureCache);
+
+					bool useStreaming = Resources::TextureStreamer::isStreamingEnabled();
+					if (ImGui::Checkbox("Texture streaming (smallest mips first)", &useStreaming))
+						Resources::TextureStreamer::setEnabled(useStreaming);
+
+					if (useStreaming)
+					{
+						int frameBudget = (int)(Resources::TextureStreamer::getFrameBudget() / 1024);
+						if (ImGui::InputInt("Upload budget per frame (KB)", &frameBudget))
+							Resources::TextureStreamer::setFrameBudget((size_t)std::max(frameBudget, 1) * 1024);
+
+						int residencyCap = (int)(Resources::TextureStreamer::getResidencyCap() / (1024 * 1024));
+						if (ImGui::InputInt("Textures residency cap (MB)", &residencyCap))
+							Resources::TextureStreamer::setResidencyCap((size_t)std::max(residencyCap, 1) * 1024 * 1024);
+					}
+
+					Resources::VertexLayout curLayout = Resources::ResourcesManager::getVertexLayout();
+					if (ImGui::BeginCombo("Vertex layout", Resources::Vertex::getLayoutName(curLayout)))
+					{
+						for (Resources::VertexLayout layout : { Resources::VertexLayout::STANDARD, Resources::VertexLayout::PACKED_NORMALS, Resources::VertexLayout::OCTAHEDRAL_NORMALS })
+						{
+							if (ImGui::Selectable(Resources::Vertex::getLayoutName(layout), layout == curLayout))
+								Resources::ResourcesManager::setVertexLayout(layout);
+						}
+
+						ImGui::EndCombo();
+					}
+
 					ImGui::Spacing();
 
 					if (ImGui::BeginTabBar("##Tabs", 0))
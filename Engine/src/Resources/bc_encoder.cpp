@@ -0,0 +1,277 @@
+#include "bc_encoder.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+
+namespace Resources::BC
+{
+	#pragma region ____BLOCKS____
+
+	static inline uint16_t packColor565(const float color[3])
+	{
+		int r = std::clamp((int)(color[0] * 31.f / 255.f + 0.5f), 0, 31);
+		int g = std::clamp((int)(color[1] * 63.f / 255.f + 0.5f), 0, 63);
+		int b = std::clamp((int)(color[2] * 31.f / 255.f + 0.5f), 0, 31);
+
+		return (uint16_t)((r << 11) | (g << 5) | b);
+	}
+
+	static inline void unpackColor565(uint16_t packed, int color[3])
+	{
+		int r = (packed >> 11) & 31;
+		int g = (packed >> 5) & 63;
+		int b = packed & 31;
+
+		color[0] = (r << 3) | (r >> 2);
+		color[1] = (g << 2) | (g >> 4);
+		color[2] = (b << 3) | (b >> 2);
+	}
+
+	// Color block: endpoints on the principal axis of the colors, 4 colors mode
+	static void compressColorBlock(const unsigned char block[16][4], unsigned char* output)
+	{
+		float mean[3] = { 0.f, 0.f, 0.f };
+		for (int i = 0; i < 16; i++)
+		{
+			for (int c = 0; c < 3; c++)
+				mean[c] += block[i][c];
+		}
+
+		for (int c = 0; c < 3; c++)
+			mean[c] /= 16.f;
+
+		// Covariance of the colors, its main eigenvector is found by power iterations
+		float covariance[6] = { 0.f };
+		for (int i = 0; i < 16; i++)
+		{
+			float r = block[i][0] - mean[0], g = block[i][1] - mean[1], b = block[i][2] - mean[2];
+
+			covariance[0] += r * r;
+			covariance[1] += r * g;
+			covariance[2] += r * b;
+			covariance[3] += g * g;
+			covariance[4] += g * b;
+			covariance[5] += b * b;
+		}
+
+		float axis[3] = { 1.f, 1.f, 1.f };
+		for (int iteration = 0; iteration < 4; iteration++)
+		{
+			float x = axis[0] * covariance[0] + axis[1] * covariance[1] + axis[2] * covariance[2];
+			float y = axis[0] * covariance[1] + axis[1] * covariance[3] + axis[2] * covariance[4];
+			float z = axis[0] * covariance[2] + axis[1] * covariance[4] + axis[2] * covariance[5];
+
+			float length = std::max({ fabsf(x), fabsf(y), fabsf(z) });
+			if (length < 1e-6f)
+				break;
+
+			axis[0] = x / length;
+			axis[1] = y / length;
+			axis[2] = z / length;
+		}
+
+		// Extreme colors along the axis
+		int minId = 0, maxId = 0;
+		float minDot = 1e30f, maxDot = -1e30f;
+		for (int i = 0; i < 16; i++)
+		{
+			float dot = block[i][0] * axis[0] + block[i][1] * axis[1] + block[i][2] * axis[2];
+
+			if (dot < minDot)
+			{
+				minDot = dot;
+				minId = i;
+			}
+			if (dot > maxDot)
+			{
+				maxDot = dot;
+				maxId = i;
+			}
+		}
+
+		float maxColor[3] = { (float)block[maxId][0], (float)block[maxId][1], (float)block[maxId][2] };
+		float minColor[3] = { (float)block[minId][0], (float)block[minId][1], (float)block[minId][2] };
+
+		uint16_t color0 = packColor565(maxColor);
+		uint16_t color1 = packColor565(minColor);
+
+		// color0 > color1 selects the 4 colors mode
+		if (color0 < color1)
+			std::swap(color0, color1);
+
+		uint32_t indices = 0;
+
+		if (color0 != color1)
+		{
+			int palette[4][3];
+			unpackColor565(color0, palette[0]);
+			unpackColor565(color1, palette[1]);
+
+			for (int c = 0; c < 3; c++)
+			{
+				palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+			}
+
+			for (int i = 0; i < 16; i++)
+			{
+				int bestId = 0, bestDistance = INT32_MAX;
+				for (int p = 0; p < 4; p++)
+				{
+					int r = block[i][0] - palette[p][0], g = block[i][1] - palette[p][1], b = block[i][2] - palette[p][2];
+					int distance = r * r + g * g + b * b;
+
+					if (distance < bestDistance)
+					{
+						bestDistance = distance;
+						bestId = p;
+					}
+				}
+
+				indices |= (uint32_t)bestId << (i * 2);
+			}
+		}
+
+		memcpy(output, &color0, sizeof(color0));
+		memcpy(output + 2, &color1, sizeof(color1));
+		memcpy(output + 4, &indices, sizeof(indices));
+	}
+
+	// Single channel block: min and max as endpoints, 8 values mode
+	static void compressChannelBlock(const unsigned char values[16], unsigned char* output)
+	{
+		unsigned char minValue = 255, maxValue = 0;
+		for (int i = 0; i < 16; i++)
+		{
+			minValue = std::min(minValue, values[i]);
+			maxValue = std::max(maxValue, values[i]);
+		}
+
+		output[0] = maxValue;
+		output[1] = minValue;
+
+		uint64_t indices = 0;
+
+		if (maxValue != minValue)
+		{
+			int palette[8] = { maxValue, minValue };
+			for (int p = 1; p < 7; p++)
+				palette[p + 1] = ((7 - p) * maxValue + p * minValue) / 7;
+
+			for (int i = 0; i < 16; i++)
+			{
+				int bestId = 0, bestDistance = INT32_MAX;
+				for (int p = 0; p < 8; p++)
+				{
+					int distance = abs(values[i] - palette[p]);
+
+					if (distance < bestDistance)
+					{
+						bestDistance = distance;
+						bestId = p;
+					}
+				}
+
+				indices |= (uint64_t)bestId << (i * 3);
+			}
+		}
+
+		// 48 bits of 3 bits indices
+		for (int i = 0; i < 6; i++)
+			output[2 + i] = (unsigned char)(indices >> (i * 8));
+	}
+
+	#pragma endregion
+
+	Format getFormat(const unsigned char* pixels, int width, int height, int channels)
+	{
+		switch (channels)
+		{
+		case 1: return Format::BC4;
+		case 2: return Format::BC5;
+		case 3: return Format::BC1;
+		default: break;
+		}
+
+		size_t pixelsCount = (size_t)width * height;
+		for (size_t i = 0; i < pixelsCount; i++)
+		{
+			if (pixels[i * 4 + 3] != 255)
+				return Format::BC3;
+		}
+
+		return Format::BC1;
+	}
+
+	size_t getBlockSize(Format format)
+	{
+		return format == Format::BC1 || format == Format::BC4 ? 8 : 16;
+	}
+
+	size_t getLevelSize(Format format, int width, int height)
+	{
+		return (size_t)((width + 3) / 4) * ((height + 3) / 4) * getBlockSize(format);
+	}
+
+	void compress(Format format, const unsigned char* pixels, int width, int height, int channels, unsigned char* output)
+	{
+		unsigned char block[16][4];
+		unsigned char channel[16];
+
+		for (int blockY = 0; blockY < height; blockY += 4)
+		{
+			for (int blockX = 0; blockX < width; blockX += 4)
+			{
+				// Gather the block in RGBA, clamped to the image
+				for (int i = 0; i < 16; i++)
+				{
+					int x = std::min(blockX + (i & 3), width - 1);
+					int y = std::min(blockY + (i >> 2), height - 1);
+					const unsigned char* pixel = pixels + ((size_t)y * width + x) * channels;
+
+					block[i][0] = pixel[0];
+					block[i][1] = channels > 1 ? pixel[1] : pixel[0];
+					block[i][2] = channels > 2 ? pixel[2] : pixel[0];
+					block[i][3] = channels > 3 ? pixel[3] : 255;
+				}
+
+				switch (format)
+				{
+				case Format::BC1:
+					compressColorBlock(block, output);
+					break;
+
+				case Format::BC3:
+					for (int i = 0; i < 16; i++)
+						channel[i] = block[i][3];
+
+					compressChannelBlock(channel, output);
+					compressColorBlock(block, output + 8);
+					break;
+
+				case Format::BC4:
+					for (int i = 0; i < 16; i++)
+						channel[i] = block[i][0];
+
+					compressChannelBlock(channel, output);
+					break;
+
+				case Format::BC5:
+					for (int c = 0; c < 2; c++)
+					{
+						for (int i = 0; i < 16; i++)
+							channel[i] = block[i][c];
+
+						compressChannelBlock(channel, output + c * 8);
+					}
+					break;
+				}
+
+				output += getBlockSize(format);
+			}
+		}
+	}
+}
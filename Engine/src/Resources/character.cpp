@@ -1,113 +1,350 @@
 #include "character.hpp"
 
-#include <glad/glad.h>
+#include <sstream>
+#include <cstring>
+#include <imgui.h>
 
-#include "debug.hpp"
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+#include "imstb_rectpack.h"
+
+#include "render_manager.hpp"
 #include "resources_manager.hpp"
+#include "game_object.hpp"
+#include "benchmark.hpp"
+#include "transform.hpp"
+#include "graph.hpp"
+#include "debug.hpp"
 
 namespace Resources
 {
-	Font::Font(const std::string& path)
+	#pragma region ____FONT____
+
+	Font::~Font()
+	{
+		if (ID)
+		{
+			glDeleteTextures(1, &ID);
+			Core::Engine::Benchmark::addTexturesMemory(-(long long)atlasSize * atlasSize);
+		}
+	}
+
+	bool Font::rasterize(const std::string& filePath)
 	{
 		FT_Library ft;
 		if (FT_Init_FreeType(&ft))
 		{
-			Core::Debug::Log::error("Unable to init freetype lib" + path);
-			return;
+			Core::Debug::Log::error("Unable to init freetype lib " + filePath);
+			return false;
 		}
 
 		FT_Face face;
-		if (FT_New_Face(ft, "resources/fonts/test.ttf", 0, &face))
+		if (FT_New_Face(ft, filePath.c_str(), 0, &face))
 		{
-			Core::Debug::Log::error("Unable to load the font " + path);
-			return;
+			Core::Debug::Log::error("Unable to load the font " + filePath);
+			FT_Done_FreeType(ft);
+			return false;
+		}
+
+		FT_Set_Pixel_Sizes(face, 0, FONT_PIXEL_SIZE);
+
+		lineHeight = (float)(face->size->metrics.height >> 6);
+
+		// Glyphs kept until they are packed, the pitch of the FreeType bitmaps is dropped
+		std::vector<std::vector<unsigned char>> bitmaps(charMap.size());
+		std::vector<stbrp_rect> rects;
+
+		for (int c = FONT_FIRST_CHAR; c <= FONT_LAST_CHAR; c++)
+		{
+			if (FT_Load_Char(face, c, FT_LOAD_RENDER))
+			{
+				Core::Debug::Log::warning("Unable to load the glyph " + std::to_string(c) + " of the font " + filePath);
+				continue;
+			}
+
+			const FT_GlyphSlot glyph = face->glyph;
+			int index = c - FONT_FIRST_CHAR;
+
+			charMap[index].size = Core::Maths::vec2((float)glyph->bitmap.width, (float)glyph->bitmap.rows);
+			charMap[index].bearing = Core::Maths::vec2((float)glyph->bitmap_left, (float)glyph->bitmap_top);
+			charMap[index].advance = (float)(glyph->advance.x >> 6);
+
+			if (glyph->bitmap.width == 0 || glyph->bitmap.rows == 0)
+				continue;
+
+			std::vector<unsigned char>& bitmap = bitmaps[index];
+			bitmap.resize((size_t)glyph->bitmap.width * glyph->bitmap.rows);
+
+			for (unsigned int y = 0; y < glyph->bitmap.rows; y++)
+				memcpy(bitmap.data() + (size_t)y * glyph->bitmap.width, glyph->bitmap.buffer + (ptrdiff_t)y * glyph->bitmap.pitch, glyph->bitmap.width);
+
+			stbrp_rect rect = {};
+			rect.id = index;
+			rect.w = (stbrp_coord)(glyph->bitmap.width + 2 * FONT_PADDING);
+			rect.h = (stbrp_coord)(glyph->bitmap.rows + 2 * FONT_PADDING);
+			rects.push_back(rect);
+		}
+
+		FT_Done_Face(face);
+		FT_Done_FreeType(ft);
+
+		// Smallest square atlas holding all the glyphs
+		std::vector<stbrp_node> nodes;
+		stbrp_context context;
+
+		for (atlasSize = 128; atlasSize <= FONT_MAX_ATLAS_SIZE; atlasSize *= 2)
+		{
+			nodes.resize(atlasSize);
+			stbrp_init_target(&context, atlasSize, atlasSize, nodes.data(), (int)nodes.size());
+
+			if (rects.empty() || stbrp_pack_rects(&context, rects.data(), (int)rects.size()))
+				break;
 		}
 
-		FT_Set_Pixel_Sizes(face, 0, 48);
+		if (atlasSize > FONT_MAX_ATLAS_SIZE)
+		{
+			Core::Debug::Log::error("The glyphs of the font " + filePath + " do not fit in one atlas");
+			atlasSize = 0;
+			return false;
+		}
 
-		if (FT_Load_Char(face, 'X', FT_LOAD_RENDER))
+		atlas.assign((size_t)atlasSize * atlasSize, 0);
+
+		for (const stbrp_rect& rect : rects)
 		{
-			Core::Debug::Log::error("Unable to load the font glyph " + path);
+			Character& character = charMap[rect.id];
+			const std::vector<unsigned char>& bitmap = bitmaps[rect.id];
+
+			int width = (int)character.size.x, height = (int)character.size.y;
+			int x = rect.x + FONT_PADDING, y = rect.y + FONT_PADDING;
+
+			for (int row = 0; row < height; row++)
+				memcpy(atlas.data() + (size_t)(y + row) * atlasSize + x, bitmap.data() + (size_t)row * width, width);
+
+			character.uvRect = Core::Maths::vec4((float)x / atlasSize, (float)y / atlasSize, (float)width / atlasSize, (float)height / atlasSize);
+		}
+
+		return true;
+	}
+
+	void Font::create(const std::string& filePath, bool isOnRequest)
+	{
+		m_filePath = filePath;
+
+		if (!rasterize(filePath))
+		{
+			loadWaiters.release();
 			return;
 		}
 
-        glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // disable byte-alignment restriction
-
-        for (unsigned char c = 0; c < 128; c++)
-        {
-            // load character glyph 
-            if (FT_Load_Char(face, c, FT_LOAD_RENDER))
-            {
-                std::cout << "ERROR::FREETYTPE: Failed to load Glyph" << std::endl;
-                continue;
-            }
-            // generate texture
-            unsigned int texture;
-            glGenTextures(1, &texture);
-            glBindTexture(GL_TEXTURE_2D, texture);
-            glTexImage2D(
-                GL_TEXTURE_2D,
-                0,
-                GL_RED,
-                face->glyph->bitmap.width,
-                face->glyph->bitmap.rows,
-                0,
-                GL_RED,
-                GL_UNSIGNED_BYTE,
-                face->glyph->bitmap.buffer
-            );
-            // set texture options
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            // now store character for later use
-            Character character = {
-                texture,
-                Core::Maths::vec2((float)face->glyph->bitmap.width, (float)face->glyph->bitmap.rows),
-                Core::Maths::vec2((float)face->glyph->bitmap_left, (float)face->glyph->bitmap_top),
-				(unsigned int)face->glyph->advance.x
-            };
-
-            charMap.insert(std::pair<char, Character>(c, character));
-        }
-
-        FT_Done_Face(face);
-        FT_Done_FreeType(ft);
-	}
-
-	Text::Text(Engine::GameObject& gameObject, std::shared_ptr<Text> ptr)
-		: Component(gameObject, ptr)
-	{
-		m_shaderProgram = Resources::ResourcesManager::loadShaderProgram("skyBox");
-	}
-
-	Text::Text(Engine::GameObject& gameObject, const std::string& path)
+		if (isOnRequest)
+			Core::Engine::Graph::addRequest([this]() { generate(); });
+		else
+			generate();
+	}
+
+	void Font::generate()
+	{
+		glGenTextures(1, &ID);
+		glBindTexture(GL_TEXTURE_2D, ID);
+
+		// No mips, they would mix the glyphs
+		glTexStorage2D(GL_TEXTURE_2D, 1, GL_R8, atlasSize, atlasSize);
+
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, atlasSize, atlasSize, GL_RED, GL_UNSIGNED_BYTE, atlas.data());
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		Core::Engine::Benchmark::addTexturesCount(1);
+		Core::Engine::Benchmark::addTexturesMemory((long long)atlas.size());
+
+		// Only the GPU copy is used from now on
+		std::vector<unsigned char>().swap(atlas);
+
+		isDrawable = true;
+		loadWaiters.release();
+	}
+
+	GLuint Font::getID() const
+	{
+		return ID;
+	}
+
+	const Character* Font::getCharacter(char c) const
+	{
+		if (c < FONT_FIRST_CHAR || c > FONT_LAST_CHAR)
+			return nullptr;
+
+		return &charMap[c - FONT_FIRST_CHAR];
+	}
+
+	float Font::getLineHeight() const
+	{
+		return lineHeight;
+	}
+
+	#pragma endregion
+
+	#pragma region ____TEXT____
+
+	Text::Text(Engine::GameObject& gameObject, const std::shared_ptr<Text>& ptr)
+		: Renderer(gameObject, ptr, "textShader")
+	{
+		LowRenderer::RenderManager::linkComponent(ptr);
+	}
+
+	Text::Text(Engine::GameObject& gameObject, const std::string& fontPath, const std::string& text, bool isMulti)
 		: Text(gameObject, std::shared_ptr<Text>(this))
 	{
-		m_font = Resources::ResourcesManager::loadFont(path);
+		m_font = Resources::ResourcesManager::loadFont(fontPath, isMulti);
+		m_text = text;
+	}
+
+	void Text::onDestroy()
+	{
+		Component::onDestroy();
+
+		LowRenderer::RenderManager::removeComponent(this);
+	}
+
+	void Text::setText(const std::string& text)
+	{
+		if (text == m_text)
+			return;
+
+		m_text = text;
+		isDirty = true;
 	}
 
-	Text::~Text()
+	const std::string& Text::getText() const
 	{
-		//Core::Debug::Log::info("Unload model " + cubeMap;
+		return m_text;
 	}
 
-	void Text::draw() const
+	const std::shared_ptr<Font>& Text::getFont() const
 	{
-		
+		return m_font;
+	}
+
+	void Text::buildVertices() const
+	{
+		vertices.clear();
+		vertices.reserve(m_text.size() * 6);
+
+		// One unit is the font pixel size, the transform scales the text
+		const float unit = 1.f / FONT_PIXEL_SIZE;
+		float penX = 0.f, penY = 0.f;
+
+		for (char c : m_text)
+		{
+			if (c == '\n')
+			{
+				penX = 0.f;
+				penY -= m_font->getLineHeight() * unit;
+				continue;
+			}
+
+			const Character* character = m_font->getCharacter(c);
+			if (!character)
+				continue;
+
+			float left = penX + character->bearing.x * unit;
+			float top = penY + character->bearing.y * unit;
+			float right = left + character->size.x * unit;
+			float bottom = top - character->size.y * unit;
+
+			penX += character->advance * unit;
+
+			if (character->size.x == 0.f || character->size.y == 0.f)
+				continue;
+
+			// The glyph rows are stored from the top
+			const Core::Maths::vec4& uv = character->uvRect;
+			float u0 = uv.x, v0 = uv.y, u1 = uv.x + uv.z, v1 = uv.y + uv.w;
+
+			vertices.push_back(Core::Maths::vec4(left, top, u0, v0));
+			vertices.push_back(Core::Maths::vec4(left, bottom, u0, v1));
+			vertices.push_back(Core::Maths::vec4(right, bottom, u1, v1));
+
+			vertices.push_back(Core::Maths::vec4(left, top, u0, v0));
+			vertices.push_back(Core::Maths::vec4(right, bottom, u1, v1));
+			vertices.push_back(Core::Maths::vec4(right, top, u1, v0));
+		}
+
+		isDirty = false;
+	}
+
+	void Text::batch(std::vector<TextVertex>& batchVertices) const
+	{
+		if (!m_font->isDrawable)
+			return;
+
+		if (isDirty)
+			buildVertices();
+
+		Core::Maths::mat4 model = m_transform->getGlobalModel();
+
+		for (const Core::Maths::vec4& vertex : vertices)
+		{
+			Core::Maths::vec4 position = model * Core::Maths::vec4(vertex.x, vertex.y, 0.f, 1.f);
+
+			batchVertices.push_back({ Core::Maths::vec4(position.x, position.y, vertex.z, vertex.w), m_color });
+		}
+	}
+
+	void Text::drawImGui()
+	{
+		ImGui::PushID(this);
+
+		if (ImGui::TreeNode("Text"))
+		{
+			std::string fontStr = "Font : " + m_font->m_name;
+			ImGui::Text(fontStr.c_str());
+
+			char buffer[256];
+			strncpy(buffer, m_text.c_str(), sizeof(buffer) - 1);
+			buffer[sizeof(buffer) - 1] = '\0';
+
+			if (ImGui::InputText("Text", buffer, sizeof(buffer)))
+				setText(buffer);
+
+			ImGui::ColorEdit4("Color", m_color.e);
+
+			Component::drawImGui();
+
+			ImGui::TreePop();
+		}
+
+		ImGui::PopID();
 	}
 
 	std::string Text::toString() const
 	{
-		return "";
+		// The string ends the line, it can hold spaces
+		return "COMP TEXT " + m_font->m_name + " " + std::to_string(m_color.x) + " " + std::to_string(m_color.y) + " " +
+			std::to_string(m_color.z) + " " + std::to_string(m_color.w) + " " + m_text;
 	}
 
-	void Text::parseComponent(Engine::GameObject& gameObject, std::istringstream& iss)
+	void Text::parseComponent(Engine::GameObject& gameObject, std::istringstream& iss, bool isMulti)
 	{
-		std::string path;
-		iss >> path;
+		std::string fontPath, text;
+		Core::Maths::vec4 color;
 
-		gameObject.addComponent<Text>(path);
+		iss >> fontPath;
+		iss >> color.x >> color.y >> color.z >> color.w;
+
+		std::getline(iss >> std::ws, text);
+
+		gameObject.addComponent<Text>(fontPath, text, isMulti)->m_color = color;
 	}
-}
\ No newline at end of file
+
+	#pragma endregion
+}
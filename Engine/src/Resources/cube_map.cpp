@@ -2,6 +2,7 @@
 
 #include "stb_image.h"
 
+#include "utils.hpp"
 #include "graph.hpp"
 #include "define.hpp"
 #include "debug.hpp"
@@ -10,76 +11,201 @@ namespace Resources
 {
 	CubeMap::~CubeMap()
 	{
+		freeFaces();
+
 		if (ID)
+		{
 			glDeleteTextures(1, &ID);
+			Core::Engine::Benchmark::addTexturesMemory(-(long long)residentSize);
+		}
 	}
 
-	void CubeMap::create(const std::vector<std::string>& paths, bool isMulti)
+	void CubeMap::create(const std::vector<std::string>& _paths, bool isMulti, bool _isOnRequest, bool _useCache, const std::shared_ptr<Core::TaskGroup>& tasks)
 	{
-		stbi_set_flip_vertically_on_load_thread(false);
+		if (_paths.size() < paths.size())
+		{
+			Core::Debug::Log::error("A cube map needs 6 faces");
+			loadWaiters.release();
+			return;
+		}
+
+		for (size_t i = 0; i < paths.size(); i++)
+			paths[i] = PROJECT_DIR + _paths[i];
 
-		int channel;
-		unsigned int dimIndex, dimIndexUp;
+		isOnRequest = _isOnRequest;
+		useCache = _useCache;
 
-		for (unsigned int i = 0; i < 6; i++)
+		std::shared_ptr<Core::TaskGroup> group = tasks ? tasks : std::make_shared<Core::TaskGroup>("Cube map " + paths.back());
+		std::string dirPath = Utils::getDirectory(_paths.back());
+
+		// Ended with the release of the waiters
+		std::shared_ptr<Core::Task> uploaded = group->addEvent("Cube map " + dirPath + " upload");
+		loadWaiters.addEvent(uploaded);
+
+		// The prefiltered faces are mapped as they are, nothing to decode
+		if (useCache && CubeMapCache::read(paths, compressed))
 		{
-			dimIndex = i * 2;
-			dimIndexUp = dimIndex + 1;
+			uploaded->submit();
+			upload();
+			return;
+		}
 
-			std::string absPath = PROJECT_DIR + paths[i];
-			datas[i] = stbi_load(absPath.c_str(), &dimensions[dimIndex], &dimensions[dimIndexUp], &channel, 0);
+		compressed = CubeMapCache::Faces();
 
-			if (!datas[i])
-			{
-				// Error on load (missing textures or fail open file)
-				const char* error = stbi_failure_reason();
-				std::string errorStr = error + ' ';
+		// Join of the faces, run by the thread of the last decoded one
+		std::shared_ptr<Core::Task> facesDecoded = group->add("Cube map " + dirPath + " faces", [this]() { endFaces(); }, false);
+		uploaded->after(facesDecoded);
 
-				Core::Debug::Log::error(error + paths[i]);
-				continue;
-			}
+		std::vector<std::shared_ptr<Core::Task>> faces;
+		for (size_t i = 0; i < paths.size(); i++)
+		{
+			faces.push_back(group->add("Cube map face " + _paths[i], [this, i]() { loadFace(i); }, isMulti));
+			facesDecoded->after(faces.back());
+		}
+
+		uploaded->submit();
+		facesDecoded->submit();
+
+		for (const std::shared_ptr<Core::Task>& face : faces)
+			face->submit();
+	}
+
+	void CubeMap::loadFace(size_t index)
+	{
+		stbi_set_flip_vertically_on_load_thread(false);
+
+		// RGBA whatever the images, the faces share one storage
+		int width = 0, height = 0, channels = 0;
+		datas[index] = stbi_load(paths[index].c_str(), &width, &height, &channels, 4);
 
-			Core::Debug::Log::info("Loading of " + paths[i] + " done with success");
+		if (!datas[index])
+		{
+			// Error on load (missing textures or fail open file)
+			const char* error = stbi_failure_reason();
+
+			Core::Debug::Log::error(error + paths[index]);
 		}
+		else if (useCache)
+		{
+			// The sky has no alpha, its faces are BC1
+			TextureCache::compress(datas[index], width, height, 4, BC::Format::BC1, compressed[index]);
 
-		if (isMulti)
+			stbi_image_free(datas[index]);
+			datas[index] = nullptr;
+		}
+		else
+			Mipmap::generate(datas[index], width, height, 4, mips[index]);
+	}
+
+	void CubeMap::endFaces()
+	{
+		if (useCache && !CubeMapCache::write(paths, compressed))
+			Core::Debug::Log::warning("Unable to write the cube map cache of " + paths.back());
+
+		upload();
+	}
+
+	void CubeMap::upload()
+	{
+		if (isOnRequest)
+			Core::Engine::Graph::addRequest([this]() { generate(); });
+		else
+			generate();
+	}
+
+	void CubeMap::freeFaces()
+	{
+		for (unsigned char*& data : datas)
 		{
-			Core::Engine::Graph::addRequest(std::bind(&CubeMap::generate, this));
-			return;
+			if (data)
+				stbi_image_free(data);
+
+			data = nullptr;
 		}
 
-		generate();
+		mips = {};
+		compressed = CubeMapCache::Faces();
 	}
 
 	void CubeMap::generate()
 	{
-		glGenTextures(1, &ID);
-		glBindTexture(GL_TEXTURE_2D, ID);
+		bool isCompressed = !compressed[0].levels.empty();
 
-		unsigned int dimIndex, dimIndexUp;
+		// Immutable storage: 6 square faces of the same size
+		int size = 0;
+		GLint levelsCount = 0;
+		bool isValid = true;
 
-		for (unsigned int i = 0; i < 6; i++)
+		for (size_t i = 0; i < paths.size(); i++)
 		{
-			dimIndex = i * 2;
-			dimIndexUp = dimIndex + 1;
+			GLint faceLevelsCount = isCompressed ? (GLint)compressed[i].levels.size() : (GLint)mips[i].levels.size();
+			if (faceLevelsCount == 0)
+			{
+				isValid = false;
+				break;
+			}
 
-			if (datas[i])
+			int width = isCompressed ? compressed[i].levels[0].width : mips[i].levels[0].width;
+			int height = isCompressed ? compressed[i].levels[0].height : mips[i].levels[0].height;
+
+			if (i == 0)
 			{
-				glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGBA, dimensions[dimIndex], dimensions[dimIndexUp], 0, GL_RGBA, GL_UNSIGNED_BYTE, datas[i]);
-				stbi_image_free(datas[i]);
+				size = width;
+				levelsCount = faceLevelsCount;
 			}
 
+			isValid &= width == height && width == size && faceLevelsCount == levelsCount;
 		}
 
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		if (!isValid)
+		{
+			Core::Debug::Log::error("The faces of the cube map " + paths.back() + " must be 6 square images of the same size");
+			freeFaces();
+			loadWaiters.release();
+			return;
+		}
+
+		glGenTextures(1, &ID);
+		glBindTexture(GL_TEXTURE_CUBE_MAP, ID);
+
+		GLenum internalFormat = isCompressed ? GL_COMPRESSED_RGB_S3TC_DXT1_EXT : GL_RGBA8;
+		glTexStorage2D(GL_TEXTURE_CUBE_MAP, levelsCount, internalFormat, size, size);
+
+		for (size_t i = 0; i < paths.size(); i++)
+		{
+			GLenum target = GL_TEXTURE_CUBE_MAP_POSITIVE_X + (GLenum)i;
+
+			for (GLint level = 0; level < levelsCount; level++)
+			{
+				if (isCompressed)
+				{
+					const TextureCache::Level& cur = compressed[i].levels[level];
+					glCompressedTexSubImage2D(target, level, 0, 0, cur.width, cur.height, internalFormat, (GLsizei)cur.size, cur.data);
+					residentSize += cur.size;
+				}
+				else
+				{
+					const Mipmap::Level& cur = mips[i].levels[level];
+					glTexSubImage2D(target, level, 0, 0, cur.width, cur.height, GL_RGBA, GL_UNSIGNED_BYTE, cur.pixels);
+					residentSize += cur.size;
+				}
+			}
+		}
+
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, levelsCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
 		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
 
+		freeFaces();
+
 		Core::Engine::Benchmark::addTexturesCount(6);
+		Core::Engine::Benchmark::addTexturesMemory((long long)residentSize);
 
 		isDrawable = true;
+
+		loadWaiters.release();
 	}
 
 	GLuint CubeMap::getID() const
@@ -91,4 +217,4 @@ namespace Resources
 	{
 		glBindTexture(GL_TEXTURE_CUBE_MAP, ID);
 	}
-}
\ No newline at end of file
+}
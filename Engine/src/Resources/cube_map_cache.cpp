@@ -0,0 +1,118 @@
+#include "cube_map_cache.hpp"
+
+#include <memory>
+#include <cstring>
+#include <cstdint>
+#include <filesystem>
+
+#include "mapped_file.hpp"
+#include "binary_io.hpp"
+#include "hash.hpp"
+
+namespace Resources::CubeMapCache
+{
+	static const char magic[4] = { 'R', 'C', 'U', 'B' };
+
+	std::string getCachePath(const std::array<std::string, 6>& facePaths)
+	{
+		// Keyed on the face names too, the skyboxes of a same folder do not share a cache
+		uint64_t hash = 0;
+		for (const std::string& facePath : facePaths)
+		{
+			std::string fileName = std::filesystem::path(facePath).filename().string();
+			hash = Utils::hashBytes(fileName.data(), fileName.size(), hash);
+		}
+
+		return (std::filesystem::path(facePaths.back()).parent_path() / ("cubemap_" + std::to_string(hash) + ".cube")).string();
+	}
+
+	bool read(const std::array<std::string, 6>& facePaths, Faces& faces)
+	{
+		std::shared_ptr<Utils::MappedFile> file = std::make_shared<Utils::MappedFile>(getCachePath(facePaths));
+		if (!file->isOpen())
+			return false;
+
+		Utils::BinaryReader reader(file->data(), file->end());
+
+		const char* fileMagic = reader.bytes(sizeof(magic));
+		if (!fileMagic || memcmp(fileMagic, magic, sizeof(magic)) != 0
+			|| reader.value<uint32_t>() != CUBE_MAP_CACHE_VERSION)
+			return false;
+
+		// A missing face is a baked asset, only the present ones are checked
+		for (const std::string& facePath : facePaths)
+		{
+			uint64_t sourceSize = 0;
+			int64_t sourceTime = 0;
+			bool hasSource = Utils::getSourceKey(facePath, sourceSize, sourceTime);
+
+			uint64_t cachedSize = reader.value<uint64_t>();
+			int64_t cachedTime = reader.value<int64_t>();
+			if (hasSource && (cachedSize != sourceSize || cachedTime != sourceTime))
+				return false;
+		}
+
+		for (TextureCache::CompressedImage& face : faces)
+		{
+			face.format = BC::Format::BC1;
+			face.channels = 4;
+
+			if (!TextureCache::readLevels(reader, face.format, face.levels))
+				return false;
+
+			// The faces are uploaded as one cube map, their chains must be the same
+			const TextureCache::CompressedImage& first = faces.front();
+			if (face.levels.size() != first.levels.size() || face.levels[0].width != first.levels[0].width
+				|| face.levels[0].height != first.levels[0].height)
+				return false;
+
+			face.file = file;
+			face.data.clear();
+		}
+
+		return true;
+	}
+
+	bool write(const std::array<std::string, 6>& facePaths, const Faces& faces)
+	{
+		uint64_t sourceSizes[6];
+		int64_t sourceTimes[6];
+		for (size_t i = 0; i < facePaths.size(); i++)
+		{
+			if (!Utils::getSourceKey(facePaths[i], sourceSizes[i], sourceTimes[i]))
+				return false;
+		}
+
+		for (const TextureCache::CompressedImage& face : faces)
+		{
+			if (face.format != BC::Format::BC1 || face.levels.empty() || face.levels.size() != faces.front().levels.size()
+				|| face.levels[0].width != faces.front().levels[0].width || face.levels[0].height != faces.front().levels[0].height)
+				return false;
+		}
+
+		return Utils::writeAtomically(getCachePath(facePaths), [&](Utils::BinaryWriter& writer)
+		{
+			writer.bytes(magic, sizeof(magic));
+			writer.value((uint32_t)CUBE_MAP_CACHE_VERSION);
+
+			for (size_t i = 0; i < facePaths.size(); i++)
+			{
+				writer.value(sourceSizes[i]);
+				writer.value(sourceTimes[i]);
+			}
+
+			for (const TextureCache::CompressedImage& face : faces)
+			{
+				writer.value((uint32_t)face.levels.size());
+				for (const TextureCache::Level& level : face.levels)
+				{
+					writer.value((uint32_t)level.width);
+					writer.value((uint32_t)level.height);
+					writer.bytes(level.data, level.size);
+				}
+			}
+
+			return true;
+		});
+	}
+}
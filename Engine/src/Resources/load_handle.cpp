@@ -0,0 +1,147 @@
+#include "load_handle.hpp"
+
+namespace Resources
+{
+	#pragma region ____LOAD_HANDLE____
+
+	LoadHandle::LoadHandle(const std::shared_ptr<LoadHandle>& parent, const CompletedCallback& onCompleted)
+		: m_parent(parent), m_onCompleted(onCompleted)
+	{
+		for (std::atomic<int>& pending : pendingJobsByType)
+			pending.store(0);
+
+		pendingJobsByType[(size_t)JobType::LOADING].store(1);
+
+		future = promise.get_future().share();
+		startTime = std::chrono::steady_clock::now();
+
+		if (m_parent)
+			m_parent->addJob(JobType::LOADING);
+	}
+
+	void LoadHandle::addJob(JobType type)
+	{
+		pendingJobs.fetch_add(1);
+		pendingJobsByType[(size_t)type].fetch_add(1);
+
+		if (m_parent)
+			m_parent->addJob(type);
+	}
+
+	void LoadHandle::endJob(JobType type)
+	{
+		pendingJobsByType[(size_t)type].fetch_sub(1);
+
+		// The last job completes the handle
+		if (pendingJobs.fetch_sub(1) == 1)
+			complete();
+
+		if (m_parent)
+			m_parent->endJob(type);
+	}
+
+	void LoadHandle::complete()
+	{
+		// Jobs added after the completion (late requests) do not complete it again
+		if (isCompleted.test_and_set())
+			return;
+
+		loadingTime.store(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count());
+
+		if (m_onCompleted)
+			m_onCompleted(getLoadingTime());
+
+		promise.set_value();
+	}
+
+	bool LoadHandle::isReady() const
+	{
+		return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+	}
+
+	void LoadHandle::wait() const
+	{
+		future.wait();
+	}
+
+	std::shared_future<void> LoadHandle::getFuture() const
+	{
+		return future;
+	}
+
+	int LoadHandle::getPendingJobs() const
+	{
+		return pendingJobs.load();
+	}
+
+	int LoadHandle::getPendingJobs(JobType type) const
+	{
+		return pendingJobsByType[(size_t)type].load();
+	}
+
+	float LoadHandle::getLoadingTime() const
+	{
+		return (float)loadingTime.load() / 1000000.f;
+	}
+
+	#pragma endregion
+
+	#pragma region ____LOAD_WAITERS____
+
+	void LoadWaiters::add(const std::shared_ptr<LoadHandle>& handle, LoadHandle::JobType type)
+	{
+		if (!handle)
+			return;
+
+		while (lock.test_and_set());
+
+		if (!isReleased)
+		{
+			handle->addJob(type);
+			waiters.push_back({ handle, type });
+		}
+
+		lock.clear();
+	}
+
+	void LoadWaiters::addEvent(const std::shared_ptr<Core::Task>& event)
+	{
+		if (!event)
+			return;
+
+		while (lock.test_and_set());
+
+		bool isLoaded = isReleased;
+		if (!isLoaded)
+			events.push_back(event);
+
+		lock.clear();
+
+		if (isLoaded)
+			event->end();
+	}
+
+	void LoadWaiters::release()
+	{
+		while (lock.test_and_set());
+
+		isReleased = true;
+
+		std::vector<std::pair<std::shared_ptr<LoadHandle>, LoadHandle::JobType>> released = std::move(waiters);
+		waiters.clear();
+
+		std::vector<std::shared_ptr<Core::Task>> releasedEvents = std::move(events);
+		events.clear();
+
+		lock.clear();
+
+		// End the jobs out of the lock, completing a handle can run its callback
+		for (auto& waiter : released)
+			waiter.first->endJob(waiter.second);
+
+		for (const std::shared_ptr<Core::Task>& event : releasedEvents)
+			event->end();
+	}
+
+	#pragma endregion
+}
@@ -23,8 +23,14 @@ namespace Resources
 			shaderProgram->setUniform(shaderName[i], &i);
 	}
 
+	bool Material::claim()
+	{
+		return !isClaimed.test_and_set();
+	}
+
 	void Material::bindTextures() const
 	{
+		// Streamed textures are drawable from their smallest level, GL samples the levels resident so far
 		if (alphaTex->isDrawable)
 			alphaTex->bind(0);
 		else
@@ -0,0 +1,126 @@
+#include "material_cache.hpp"
+
+#include <cstring>
+#include <cstdint>
+#include <filesystem>
+
+#include "mapped_file.hpp"
+#include "binary_io.hpp"
+
+namespace Resources::MaterialCache
+{
+	static const char magic[4] = { 'R', 'M', 'A', 'T' };
+
+	// Bytes of a material without its strings contents: 6 strings, 4 colors and 4 floats
+	static const size_t minMaterialSize = 6 * sizeof(uint32_t) + 4 * sizeof(LowRenderer::Color::data) + 4 * sizeof(float);
+
+	static void writeColor(Utils::BinaryWriter& writer, const LowRenderer::Color& color)
+	{
+		writer.bytes(&color.data, sizeof(color.data));
+	}
+
+	static LowRenderer::Color readColor(Utils::BinaryReader& reader)
+	{
+		LowRenderer::Color color;
+		if (const char* data = reader.bytes(sizeof(color.data)))
+			memcpy(&color.data, data, sizeof(color.data));
+
+		return color;
+	}
+
+	std::string getCachePath(const std::string& mtlPath)
+	{
+		return std::filesystem::path(mtlPath).replace_extension(".mat").string();
+	}
+
+	bool read(const std::string& mtlPath, std::vector<Mtl::MaterialData>& materials)
+	{
+		// Without its mtl the cache is a baked asset, used whatever its key
+		uint64_t sourceSize = 0;
+		int64_t sourceTime = 0;
+		bool hasSource = Utils::getSourceKey(mtlPath, sourceSize, sourceTime);
+
+		Utils::MappedFile file(getCachePath(mtlPath));
+		if (!file.isOpen())
+			return false;
+
+		Utils::BinaryReader reader(file.data(), file.end());
+
+		// Check the header and the key
+		const char* fileMagic = reader.bytes(sizeof(magic));
+		if (!fileMagic || memcmp(fileMagic, magic, sizeof(magic)) != 0
+			|| reader.value<uint32_t>() != MATERIAL_CACHE_VERSION)
+			return false;
+
+		uint64_t cachedSize = reader.value<uint64_t>();
+		int64_t cachedTime = reader.value<int64_t>();
+		if ((hasSource && (cachedSize != sourceSize || cachedTime != sourceTime)) || reader.string() != mtlPath)
+			return false;
+
+		// Bounded by the file, a corrupt count never makes a huge resize
+		materials.resize(reader.count(minMaterialSize));
+		for (Mtl::MaterialData& mat : materials)
+		{
+			mat.name = reader.string();
+
+			mat.ambient = readColor(reader);
+			mat.diffuse = readColor(reader);
+			mat.specular = readColor(reader);
+			mat.emissive = readColor(reader);
+
+			mat.shininess = reader.value<float>();
+			mat.opticalDensity = reader.value<float>();
+			mat.transparency = reader.value<float>();
+			mat.illumination = reader.value<float>();
+
+			mat.alphaTex = reader.string();
+			mat.ambientTex = reader.string();
+			mat.diffuseTex = reader.string();
+			mat.emissiveTex = reader.string();
+			mat.specularTex = reader.string();
+		}
+
+		return reader.valid;
+	}
+
+	bool write(const std::string& mtlPath, const std::vector<Mtl::MaterialData>& materials)
+	{
+		uint64_t sourceSize;
+		int64_t sourceTime;
+		if (!Utils::getSourceKey(mtlPath, sourceSize, sourceTime))
+			return false;
+
+		return Utils::writeAtomically(getCachePath(mtlPath), [&](Utils::BinaryWriter& writer)
+		{
+			writer.bytes(magic, sizeof(magic));
+			writer.value((uint32_t)MATERIAL_CACHE_VERSION);
+			writer.value(sourceSize);
+			writer.value(sourceTime);
+			writer.string(mtlPath);
+
+			writer.value((uint32_t)materials.size());
+			for (const Mtl::MaterialData& mat : materials)
+			{
+				writer.string(mat.name);
+
+				writeColor(writer, mat.ambient);
+				writeColor(writer, mat.diffuse);
+				writeColor(writer, mat.specular);
+				writeColor(writer, mat.emissive);
+
+				writer.value(mat.shininess);
+				writer.value(mat.opticalDensity);
+				writer.value(mat.transparency);
+				writer.value(mat.illumination);
+
+				writer.string(mat.alphaTex);
+				writer.string(mat.ambientTex);
+				writer.string(mat.diffuseTex);
+				writer.string(mat.emissiveTex);
+				writer.string(mat.specularTex);
+			}
+
+			return true;
+		});
+	}
+}
@@ -1,5 +1,7 @@
 #include "mesh.hpp"
 
+#include <utility>
+
 #include "graph.hpp"
 
 namespace Resources
@@ -8,7 +10,7 @@ namespace Resources
 	{
 		// Bind the mesh's VAO and draw it
 		glBindVertexArray(VAO);
-		glDrawArrays(GL_TRIANGLES, 0, (GLsizei)(attributs.size()));
+		glDrawElements(GL_TRIANGLES, (GLsizei)indicesCount, getIndexType(), (GLvoid*)0);
 		glBindVertexArray(0);
 	}
 
@@ -17,7 +19,95 @@ namespace Resources
 		if (VAO)
 			glDeleteVertexArrays(1, &VAO);
 		if (VBO)
-			glDeleteFramebuffers(1, &VBO);
+			glDeleteBuffers(1, &VBO);
+		if (EBO)
+			glDeleteBuffers(1, &EBO);
+	}
+
+	Mesh::Mesh(Mesh&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	Mesh& Mesh::operator=(Mesh&& other) noexcept
+	{
+		if (this == &other)
+			return *this;
+
+		m_filePath = std::move(other.m_filePath);
+		m_name = std::move(other.m_name);
+
+		// The GL objects change of owner
+		std::swap(VAO, other.VAO);
+		std::swap(VBO, other.VBO);
+		std::swap(EBO, other.EBO);
+
+		cacheFile = std::move(other.cacheFile);
+		cachedAttributs = std::exchange(other.cachedAttributs, nullptr);
+		cachedAttributsSize = std::exchange(other.cachedAttributsSize, 0);
+		cachedIndices = std::exchange(other.cachedIndices, nullptr);
+
+		verticesCount = std::exchange(other.verticesCount, 0);
+		indicesCount = std::exchange(other.indicesCount, 0);
+		sourceVerticesCount = std::exchange(other.sourceVerticesCount, 0);
+
+		layout = other.layout;
+		attributs = std::move(other.attributs);
+		indices = std::move(other.indices);
+		indexSize = other.indexSize;
+
+		name = std::move(other.name);
+		isDrawable = std::exchange(other.isDrawable, false);
+
+		return *this;
+	}
+
+	GLenum Mesh::getIndexType() const
+	{
+		return indexSize == sizeof(unsigned short) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+	}
+
+	void Mesh::setAttribPointers() const
+	{
+		GLsizei stride = (GLsizei)Vertex::getSize(layout);
+
+		// Set the attrib pointer to the positions
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(0));
+		glEnableVertexAttribArray(0);
+
+		size_t offset = 3 * sizeof(float);
+
+		if (layout == VertexLayout::STANDARD)
+		{
+			// Set the attrib pointer to the texture coordinates
+			glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (GLvoid*)offset);
+			glEnableVertexAttribArray(1);
+
+			// Set the attrib pointer to the normals
+			glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(offset + 2 * sizeof(float)));
+			glEnableVertexAttribArray(2);
+
+			return;
+		}
+
+		// Set the attrib pointer to the half texture coordinates
+		glVertexAttribPointer(1, 2, GL_HALF_FLOAT, GL_FALSE, stride, (GLvoid*)offset);
+		glEnableVertexAttribArray(1);
+
+		offset += 2 * sizeof(unsigned short);
+
+		// Set the attrib pointer to the packed normals, the octahedral ones go on
+		// location 3 and the shader decodes them when its octNormals uniform is set
+		if (layout == VertexLayout::PACKED_NORMALS)
+		{
+			glVertexAttribPointer(2, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, (GLvoid*)offset);
+			glEnableVertexAttribArray(2);
+		}
+		else
+		{
+			glVertexAttribPointer(3, 2, GL_SHORT, GL_TRUE, stride, (GLvoid*)offset);
+			glEnableVertexAttribArray(3);
+		}
 	}
 
 	// Generate VAO, VBO and EBO from mesh
@@ -31,53 +121,44 @@ namespace Resources
 		glGenBuffers(1, &VBO);
 		glBindBuffer(GL_ARRAY_BUFFER, VBO);
 
-		glBufferData(GL_ARRAY_BUFFER, attributs.size() * sizeof(float), attributs.data(), GL_STATIC_DRAW);
-
-		int stride = 3 * sizeof(Core::Maths::vec3);
+		// EBO initialization and binding, kept in the VAO state
+		glGenBuffers(1, &EBO);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
 
-		// Set the attrib pointer to the positions
-		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(0));
-		glEnableVertexAttribArray(0);
-
-		// Set the attrib pointer to the texture coordinates
-		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(sizeof(Core::Maths::vec3)));
-		glEnableVertexAttribArray(1);
+		// Upload straight from the cache mapping if the mesh comes from it
+		if (cachedAttributs)
+		{
+			glBufferData(GL_ARRAY_BUFFER, cachedAttributsSize, cachedAttributs, GL_STATIC_DRAW);
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, indicesCount * indexSize, cachedIndices, GL_STATIC_DRAW);
+		}
+		else
+		{
+			glBufferData(GL_ARRAY_BUFFER, attributs.size(), attributs.data(), GL_STATIC_DRAW);
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size(), indices.data(), GL_STATIC_DRAW);
+		}
 
-		// Set the attrib pointer to the normals
-		glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(2 * sizeof(Core::Maths::vec3)));
-		glEnableVertexAttribArray(2);
+		setAttribPointers();
 
 		glBindVertexArray(0);
 
+		// The mapping is not needed once the data is on the GPU
+		cacheFile = nullptr;
+		cachedAttributs = nullptr;
+		cachedAttributsSize = 0;
+		cachedIndices = nullptr;
+
 		isDrawable = true;
 
-		Core::Engine::Benchmark::addTrianglesCount(verticesCount / 3.0);
+		Core::Engine::Benchmark::addTrianglesCount(indicesCount / 3);
+		Core::Engine::Benchmark::addVerticesCount(sourceVerticesCount, verticesCount);
+		Core::Engine::Benchmark::setMeshVisible();
 	}
 
-	void Mesh::compute(std::vector<Core::Maths::vec3>& vertices, std::vector<Core::Maths::vec3>& texCoords, std::vector<Core::Maths::vec3>& normals, std::vector<unsigned int>& indices)
+	void Mesh::setCachedData(const std::shared_ptr<Utils::MappedFile>& file, const unsigned char* _attributs, size_t attributsSize, const unsigned char* _indices)
 	{
-		// Create attributs vector from mesh values
-		for (size_t i = 0; i < indices.size(); i += 3)
-		{
-			Core::Maths::vec3& vertex = vertices[indices[i]];
-			attributs.push_back(vertex.x);
-			attributs.push_back(vertex.y);
-			attributs.push_back(vertex.z);
-
-			if (!texCoords.empty())
-			{
-				Core::Maths::vec3& textureCoords = texCoords[indices[i + 1]];
-				attributs.push_back(textureCoords.x);
-				attributs.push_back(textureCoords.y);
-				attributs.push_back(textureCoords.z);
-			}
-
-			Core::Maths::vec3& normal = normals[indices[i + 2]];
-			attributs.push_back(normal.x);
-			attributs.push_back(normal.y);
-			attributs.push_back(normal.z);
-
-			verticesCount++;
-		}
+		cacheFile = file;
+		cachedAttributs = _attributs;
+		cachedAttributsSize = attributsSize;
+		cachedIndices = _indices;
 	}
-}
\ No newline at end of file
+}
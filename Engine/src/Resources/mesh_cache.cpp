@@ -0,0 +1,154 @@
+#include "mesh_cache.hpp"
+
+#include <cstring>
+#include <cstdint>
+#include <filesystem>
+
+#include "binary_io.hpp"
+
+namespace Resources::MeshCache
+{
+	static const char magic[4] = { 'R', 'M', 'S', 'H' };
+
+	// Bytes of a submesh without its strings contents, attributs and indices
+	static const size_t minSubMeshSize = 2 * sizeof(uint32_t) + 3 * sizeof(uint64_t) + sizeof(uint32_t) + sizeof(uint64_t);
+
+	template <typename Index>
+	static bool areIndicesValid(const unsigned char* indices, uint64_t indicesCount, uint64_t verticesCount)
+	{
+		for (uint64_t i = 0; i < indicesCount; i++)
+		{
+			Index index;
+			memcpy(&index, indices + i * sizeof(Index), sizeof(Index));
+
+			if (index >= verticesCount)
+				return false;
+		}
+
+		return true;
+	}
+
+	std::string getCachePath(const std::string& objPath)
+	{
+		return std::filesystem::path(objPath).replace_extension(".mesh").string();
+	}
+
+	bool read(const std::string& objPath, VertexLayout layout, CachedModel& model)
+	{
+		// Without its obj the cache is a baked asset, used whatever its key
+		uint64_t sourceSize = 0;
+		int64_t sourceTime = 0;
+		bool hasSource = Utils::getSourceKey(objPath, sourceSize, sourceTime);
+
+		std::shared_ptr<Utils::MappedFile> file = std::make_shared<Utils::MappedFile>(getCachePath(objPath));
+		if (!file->isOpen())
+			return false;
+
+		Utils::BinaryReader reader(file->data(), file->end());
+
+		// Check the header and the key
+		const char* fileMagic = reader.bytes(sizeof(magic));
+		if (!fileMagic || memcmp(fileMagic, magic, sizeof(magic)) != 0
+			|| reader.value<uint32_t>() != MESH_CACHE_VERSION
+			|| reader.value<uint32_t>() != (uint32_t)layout)
+			return false;
+
+		uint64_t cachedSize = reader.value<uint64_t>();
+		int64_t cachedTime = reader.value<int64_t>();
+		if ((hasSource && (cachedSize != sourceSize || cachedTime != sourceTime)) || reader.string() != objPath)
+			return false;
+
+		// The counts and sizes are checked against the file: a corrupt cache is rejected, never uploaded
+		model.mtlLibs.resize(reader.count(sizeof(uint32_t)));
+		for (std::string& mtlLib : model.mtlLibs)
+			mtlLib = reader.string();
+
+		model.subMeshes.resize(reader.count(minSubMeshSize));
+		for (SubMesh& subMesh : model.subMeshes)
+		{
+			subMesh.name = reader.string();
+			subMesh.matName = reader.string();
+
+			uint64_t verticesCount = reader.value<uint64_t>();
+			uint64_t indicesCount = reader.value<uint64_t>();
+			uint64_t sourceVerticesCount = reader.value<uint64_t>();
+			subMesh.indexSize = reader.value<uint32_t>();
+			uint64_t attributsSize = reader.value<uint64_t>();
+
+			if (subMesh.indexSize != sizeof(uint16_t) && subMesh.indexSize != sizeof(uint32_t))
+				return false;
+
+			// Sizes bounded by the file before any product
+			uint64_t vertexSize = Vertex::getSize(layout);
+			if (attributsSize > reader.remaining() || attributsSize % vertexSize != 0 || attributsSize / vertexSize != verticesCount
+				|| indicesCount > reader.remaining() / subMesh.indexSize)
+				return false;
+
+			subMesh.verticesCount = (long)verticesCount;
+			subMesh.indicesCount = (long)indicesCount;
+			subMesh.sourceVerticesCount = (long)sourceVerticesCount;
+			subMesh.attributsSize = (size_t)attributsSize;
+			subMesh.attributs = (const unsigned char*)reader.bytes(subMesh.attributsSize);
+			reader.align();
+			subMesh.indices = (const unsigned char*)reader.bytes((size_t)indicesCount * subMesh.indexSize);
+			reader.align();
+
+			if (!reader.valid)
+				return false;
+
+			// An index out of the vertices would be fetched out of the buffer by the GPU
+			bool areValid = subMesh.indexSize == sizeof(uint16_t) ? areIndicesValid<uint16_t>(subMesh.indices, indicesCount, verticesCount)
+				: areIndicesValid<uint32_t>(subMesh.indices, indicesCount, verticesCount);
+			if (!areValid)
+				return false;
+		}
+
+		if (!reader.valid)
+			return false;
+
+		model.file = file;
+
+		return true;
+	}
+
+	bool write(const std::string& objPath, VertexLayout layout, const std::vector<std::string>& mtlLibs, const std::vector<SubMesh>& subMeshes)
+	{
+		uint64_t sourceSize;
+		int64_t sourceTime;
+		if (!Utils::getSourceKey(objPath, sourceSize, sourceTime))
+			return false;
+
+		// Write in a temporary file so a reader never maps a partial cache
+		return Utils::writeAtomically(getCachePath(objPath), [&](Utils::BinaryWriter& writer)
+		{
+			writer.bytes(magic, sizeof(magic));
+			writer.value((uint32_t)MESH_CACHE_VERSION);
+			writer.value((uint32_t)layout);
+			writer.value(sourceSize);
+			writer.value(sourceTime);
+			writer.string(objPath);
+
+			writer.value((uint32_t)mtlLibs.size());
+			for (const std::string& mtlLib : mtlLibs)
+				writer.string(mtlLib);
+
+			writer.value((uint32_t)subMeshes.size());
+			for (const SubMesh& subMesh : subMeshes)
+			{
+				writer.string(subMesh.name);
+				writer.string(subMesh.matName);
+				writer.value((uint64_t)subMesh.verticesCount);
+				writer.value((uint64_t)subMesh.indicesCount);
+				writer.value((uint64_t)subMesh.sourceVerticesCount);
+				writer.value((uint32_t)subMesh.indexSize);
+				writer.value((uint64_t)subMesh.attributsSize);
+				writer.bytes(subMesh.attributs, subMesh.attributsSize);
+				writer.align();
+				writer.bytes(subMesh.indices, subMesh.indicesCount * subMesh.indexSize);
+				writer.align();
+			}
+
+			return true;
+		});
+	}
+}
\ No newline at end of file
@@ -0,0 +1,134 @@
+#include "mesh_data.hpp"
+
+#include <cstring>
+#include <cstdint>
+
+// Meshes with more unique vertices use 32 bits indices
+#define MESH_INDEX_16_MAX 0xFFFF
+
+namespace Resources
+{
+	void MeshData::compute(std::vector<Core::Maths::vec3>& vertices, std::vector<Core::Maths::vec3>& texCoords, std::vector<Core::Maths::vec3>& normals, std::vector<unsigned int>& indices, VertexLayout _layout)
+	{
+		compute(vertices, texCoords, normals, indices.data(), indices.size(), _layout);
+	}
+
+	// Hash of a (v, vt, vn) triplet
+	static inline size_t hashCorner(const unsigned int* corner)
+	{
+		uint64_t hash = corner[0] * 0x9E3779B97F4A7C15ull;
+		hash ^= corner[1] * 0xC2B2AE3D27D4EB4Full;
+		hash ^= corner[2] * 0x165667B19E3779F9ull;
+
+		return (size_t)(hash ^ (hash >> 29));
+	}
+
+	void MeshData::compute(const std::vector<Core::Maths::vec3>& vertices, const std::vector<Core::Maths::vec3>& texCoords, const std::vector<Core::Maths::vec3>& normals, const unsigned int* cornerIndices, size_t cornerIndicesCount, VertexLayout _layout)
+	{
+		layout = _layout;
+		unsigned int vertexSize = Vertex::getSize(layout);
+
+		size_t cornersCount = cornerIndicesCount / 3;
+
+		// First corner of each unique vertex and unique vertex of each corner
+		std::vector<unsigned int> uniqueCorners;
+		std::vector<unsigned int> vertexIndices(cornersCount);
+
+		{
+			// Open addressing table of the unique vertices, at most half full
+			size_t tableSize = 16;
+			while (tableSize < cornersCount * 2)
+				tableSize <<= 1;
+
+			const unsigned int emptySlot = ~0u;
+			std::vector<unsigned int> table(tableSize, emptySlot);
+
+			for (size_t i = 0; i < cornersCount; i++)
+			{
+				const unsigned int* corner = cornerIndices + i * 3;
+
+				size_t slot = hashCorner(corner) & (tableSize - 1);
+				while (table[slot] != emptySlot)
+				{
+					const unsigned int* other = cornerIndices + (size_t)uniqueCorners[table[slot]] * 3;
+					if (other[0] == corner[0] && other[1] == corner[1] && other[2] == corner[2])
+						break;
+
+					slot = (slot + 1) & (tableSize - 1);
+				}
+
+				// New vertex
+				if (table[slot] == emptySlot)
+				{
+					table[slot] = (unsigned int)uniqueCorners.size();
+					uniqueCorners.push_back((unsigned int)i);
+				}
+
+				vertexIndices[i] = table[slot];
+			}
+		}
+
+		// The unique vertices count is known, write them in a buffer of the exact size
+		attributs.resize(uniqueCorners.size() * vertexSize);
+		attributs.shrink_to_fit();
+
+		// Vertices without normal get the area weighted normal of the faces around them
+		std::vector<Core::Maths::vec3> generatedNormals;
+		for (size_t i = 0; i + 2 < cornersCount; i += 3)
+		{
+			const unsigned int* triangle = cornerIndices + i * 3;
+			if (triangle[2] < normals.size() && triangle[5] < normals.size() && triangle[8] < normals.size())
+				continue;
+
+			if (triangle[0] >= vertices.size() || triangle[3] >= vertices.size() || triangle[6] >= vertices.size())
+				continue;
+
+			if (generatedNormals.empty())
+				generatedNormals.resize(uniqueCorners.size());
+
+			const Core::Maths::vec3& a = vertices[triangle[0]];
+			Core::Maths::vec3 faceNormal = (vertices[triangle[3]] - a) ^ (vertices[triangle[6]] - a);
+
+			for (size_t j = 0; j < 3; j++)
+				generatedNormals[vertexIndices[i + j]] += faceNormal;
+		}
+
+		unsigned char* vertex = attributs.data();
+		for (size_t i = 0; i < uniqueCorners.size(); i++)
+		{
+			const unsigned int* corner = cornerIndices + (size_t)uniqueCorners[i] * 3;
+
+			// Keep the layout stride without texture coordinates, missing or invalid indices give zeros
+			const Core::Maths::vec3 position = corner[0] < vertices.size() ? vertices[corner[0]] : Core::Maths::vec3();
+			const Core::Maths::vec3 textureCoords = corner[1] < texCoords.size() ? texCoords[corner[1]] : Core::Maths::vec3();
+			const Core::Maths::vec3 normal = corner[2] < normals.size() ? normals[corner[2]]
+				: generatedNormals.empty() ? Core::Maths::vec3() : generatedNormals[i].normalized();
+
+			Vertex::pack(layout, vertex, position, textureCoords, normal);
+			vertex += vertexSize;
+		}
+
+		sourceVerticesCount = (long)cornersCount;
+		verticesCount = (long)uniqueCorners.size();
+		indicesCount = (long)cornersCount;
+
+		// 16 bits indices when every vertex can be addressed with them
+		if (uniqueCorners.size() <= MESH_INDEX_16_MAX)
+		{
+			indexSize = sizeof(unsigned short);
+			indices.resize(cornersCount * indexSize);
+			indices.shrink_to_fit();
+
+			unsigned short* shortIndices = (unsigned short*)indices.data();
+			for (size_t i = 0; i < cornersCount; i++)
+				shortIndices[i] = (unsigned short)vertexIndices[i];
+		}
+		else
+		{
+			indexSize = sizeof(unsigned int);
+			indices.resize(cornersCount * indexSize);
+			indices.shrink_to_fit();
+			memcpy(indices.data(), vertexIndices.data(), indices.size());
+		}
+	}
+}
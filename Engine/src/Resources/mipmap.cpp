@@ -0,0 +1,314 @@
+#include "mipmap.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+// SSE is always there on x64, the scalar loops are kept for the other targets
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MIPMAP_SSE
+#include <emmintrin.h>
+#endif
+
+#define MIPMAP_MAX_TAPS 6
+#define SRGB_TABLE_SIZE 16384
+
+namespace Resources::Mipmap
+{
+	#pragma region ____FILTERS____
+
+	// Separable 2x decimation filter, the tap k of the destination pixel x reads the source pixel 2x + firstTap + k
+	struct Kernel
+	{
+		int tapsCount = 0;
+		int firstTap = 0;
+		float weights[MIPMAP_MAX_TAPS] = {};
+	};
+
+	static double besselI0(double x)
+	{
+		double sum = 1.0, term = 1.0;
+		for (int k = 1; k < 20; k++)
+		{
+			term *= (x / (2.0 * k)) * (x / (2.0 * k));
+			sum += term;
+		}
+
+		return sum;
+	}
+
+	static Kernel buildKaiser()
+	{
+		const double pi = 3.14159265358979323846;
+		const double alpha = 4.0;
+		const double radius = 3.0;
+
+		Kernel kernel;
+		kernel.tapsCount = MIPMAP_MAX_TAPS;
+		kernel.firstTap = -2;
+
+		double sum = 0.0;
+		double weights[MIPMAP_MAX_TAPS];
+		for (int k = 0; k < MIPMAP_MAX_TAPS; k++)
+		{
+			// Distance of the source pixel to the destination pixel center (never 0), the sinc cuts at the destination frequency
+			double distance = k - 2.5;
+			double sinc = sin(pi * distance / 2.0) / (pi * distance / 2.0);
+			double t = distance / radius;
+
+			weights[k] = sinc * besselI0(alpha * sqrt(std::max(0.0, 1.0 - t * t))) / besselI0(alpha);
+			sum += weights[k];
+		}
+
+		for (int k = 0; k < MIPMAP_MAX_TAPS; k++)
+			kernel.weights[k] = (float)(weights[k] / sum);
+
+		return kernel;
+	}
+
+	static const Kernel& getKernel(Filter filter)
+	{
+		static const Kernel box = { 2, 0, { 0.5f, 0.5f } };
+		static const Kernel kaiser = buildKaiser();
+
+		return filter == Filter::KAISER ? kaiser : box;
+	}
+
+	// Vertical pass: whole rows are weighted, 4 floats at a time
+	static void filterRows(const float* const* rows, const Kernel& kernel, size_t size, float* output)
+	{
+		size_t i = 0;
+
+	#ifdef MIPMAP_SSE
+		for (; i + 4 <= size; i += 4)
+		{
+			__m128 sum = _mm_mul_ps(_mm_loadu_ps(rows[0] + i), _mm_set1_ps(kernel.weights[0]));
+
+			for (int k = 1; k < kernel.tapsCount; k++)
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(rows[k] + i), _mm_set1_ps(kernel.weights[k])));
+
+			_mm_storeu_ps(output + i, sum);
+		}
+	#endif
+
+		for (; i < size; i++)
+		{
+			float sum = 0.f;
+			for (int k = 0; k < kernel.tapsCount; k++)
+				sum += rows[k][i] * kernel.weights[k];
+
+			output[i] = sum;
+		}
+	}
+
+	// Horizontal pass: RGBA pixels are weighted as a whole, the other ones component by component
+	static void filterColumns(const float* row, int width, int channels, const Kernel& kernel, int dstWidth, float* output)
+	{
+		for (int x = 0; x < dstWidth; x++)
+		{
+			int columns[MIPMAP_MAX_TAPS];
+			for (int k = 0; k < kernel.tapsCount; k++)
+				columns[k] = std::clamp(x * 2 + kernel.firstTap + k, 0, width - 1) * channels;
+
+		#ifdef MIPMAP_SSE
+			if (channels == 4)
+			{
+				__m128 sum = _mm_mul_ps(_mm_loadu_ps(row + columns[0]), _mm_set1_ps(kernel.weights[0]));
+
+				for (int k = 1; k < kernel.tapsCount; k++)
+					sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(row + columns[k]), _mm_set1_ps(kernel.weights[k])));
+
+				_mm_storeu_ps(output + (size_t)x * 4, sum);
+				continue;
+			}
+		#endif
+
+			for (int c = 0; c < channels; c++)
+			{
+				float sum = 0.f;
+				for (int k = 0; k < kernel.tapsCount; k++)
+					sum += row[columns[k] + c] * kernel.weights[k];
+
+				output[(size_t)x * channels + c] = sum;
+			}
+		}
+	}
+
+	// Filter a float image to its next level, out of the image the last row and column are repeated
+	static void downsample(const float* src, int width, int height, int channels, const Kernel& kernel, float* dst, std::vector<float>& row)
+	{
+		int dstWidth = getNextSize(width);
+		int dstHeight = getNextSize(height);
+		size_t rowSize = (size_t)width * channels;
+
+		row.resize(rowSize);
+
+		for (int y = 0; y < dstHeight; y++)
+		{
+			const float* rows[MIPMAP_MAX_TAPS];
+			for (int k = 0; k < kernel.tapsCount; k++)
+				rows[k] = src + (size_t)std::clamp(y * 2 + kernel.firstTap + k, 0, height - 1) * rowSize;
+
+			filterRows(rows, kernel, rowSize, row.data());
+			filterColumns(row.data(), width, channels, kernel, dstWidth, dst + (size_t)y * dstWidth * channels);
+		}
+	}
+
+	#pragma endregion
+
+	#pragma region ____SRGB____
+
+	struct SrgbTables
+	{
+		float toLinear[256];
+		unsigned char fromLinear[SRGB_TABLE_SIZE + 1];
+
+		SrgbTables()
+		{
+			for (int i = 0; i < 256; i++)
+			{
+				float value = i / 255.f;
+				toLinear[i] = value <= 0.04045f ? value / 12.92f : powf((value + 0.055f) / 1.055f, 2.4f);
+			}
+
+			for (int i = 0; i <= SRGB_TABLE_SIZE; i++)
+			{
+				float value = (float)i / SRGB_TABLE_SIZE;
+				float srgb = value <= 0.0031308f ? value * 12.92f : 1.055f * powf(value, 1.f / 2.4f) - 0.055f;
+				fromLinear[i] = (unsigned char)std::clamp((int)(srgb * 255.f + 0.5f), 0, 255);
+			}
+		}
+	};
+
+	static const SrgbTables& getSrgbTables()
+	{
+		static const SrgbTables tables;
+		return tables;
+	}
+
+	static inline unsigned char encode(float value, bool isSRGB, const SrgbTables& tables)
+	{
+		if (isSRGB)
+			return tables.fromLinear[std::clamp((int)(value * SRGB_TABLE_SIZE + 0.5f), 0, SRGB_TABLE_SIZE)];
+
+		return (unsigned char)std::clamp((int)(value * 255.f + 0.5f), 0, 255);
+	}
+
+	#pragma endregion
+
+	size_t Chain::getSize() const
+	{
+		size_t size = 0;
+		for (const Level& level : levels)
+			size += level.size;
+
+		return size;
+	}
+
+	int getLevelsCount(int width, int height)
+	{
+		int levelsCount = 1;
+
+		for (int size = std::max(width, height); size > 1; size >>= 1)
+			levelsCount++;
+
+		return levelsCount;
+	}
+
+	int getNextSize(int size)
+	{
+		return std::max(size >> 1, 1);
+	}
+
+	// Sizes of the levels, and their place in the chain data
+	static void allocate(const void* pixels, int width, int height, int channels, size_t componentSize, Chain& chain)
+	{
+		chain.levels.resize(getLevelsCount(width, height));
+
+		size_t dataSize = 0;
+		for (size_t i = 0; i < chain.levels.size(); i++)
+		{
+			Level& level = chain.levels[i];
+			level.width = width;
+			level.height = height;
+			level.size = (size_t)width * height * channels * componentSize;
+
+			if (i > 0)
+				dataSize += level.size;
+
+			width = getNextSize(width);
+			height = getNextSize(height);
+		}
+
+		chain.data.resize(dataSize);
+
+		chain.levels[0].pixels = pixels;
+
+		unsigned char* data = chain.data.data();
+		for (size_t i = 1; i < chain.levels.size(); i++)
+		{
+			chain.levels[i].pixels = data;
+			data += chain.levels[i].size;
+		}
+	}
+
+	void generate(const unsigned char* pixels, int width, int height, int channels, Chain& chain, Filter filter)
+	{
+		allocate(pixels, width, height, channels, sizeof(unsigned char), chain);
+
+		if (chain.levels.size() == 1)
+			return;
+
+		const Kernel& kernel = getKernel(filter);
+		const SrgbTables& tables = getSrgbTables();
+
+		// Channels decoded from sRGB: the colors of RGB(A) images
+		int srgbChannels = channels >= 3 ? 3 : 0;
+
+		// The levels are filtered in floats, so the rounding errors do not add up along the chain
+		std::vector<float> level((size_t)width * height * channels), nextLevel, row;
+
+		for (size_t i = 0, pixelsCount = (size_t)width * height; i < pixelsCount; i++)
+		{
+			for (int c = 0; c < channels; c++)
+			{
+				unsigned char value = pixels[i * channels + c];
+				level[i * channels + c] = c < srgbChannels ? tables.toLinear[value] : value / 255.f;
+			}
+		}
+
+		for (size_t i = 1; i < chain.levels.size(); i++)
+		{
+			const Level& previous = chain.levels[i - 1];
+			const Level& current = chain.levels[i];
+
+			size_t pixelsCount = (size_t)current.width * current.height;
+			nextLevel.resize(pixelsCount * channels);
+
+			downsample(level.data(), previous.width, previous.height, channels, kernel, nextLevel.data(), row);
+
+			unsigned char* output = (unsigned char*)current.pixels;
+			for (size_t p = 0; p < pixelsCount; p++)
+			{
+				for (int c = 0; c < channels; c++)
+					output[p * channels + c] = encode(nextLevel[p * channels + c], c < srgbChannels, tables);
+			}
+
+			level.swap(nextLevel);
+		}
+	}
+
+	void generate(const float* pixels, int width, int height, int channels, Chain& chain, Filter filter)
+	{
+		allocate(pixels, width, height, channels, sizeof(float), chain);
+
+		const Kernel& kernel = getKernel(filter);
+		std::vector<float> row;
+
+		for (size_t i = 1; i < chain.levels.size(); i++)
+		{
+			const Level& previous = chain.levels[i - 1];
+
+			downsample((const float*)previous.pixels, previous.width, previous.height, channels, kernel, (float*)chain.levels[i].pixels, row);
+		}
+	}
+}
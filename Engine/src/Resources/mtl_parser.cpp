@@ -0,0 +1,76 @@
+#include "mtl_parser.hpp"
+
+#include <sstream>
+
+namespace Resources::Mtl
+{
+	static LowRenderer::Color getColor(std::istringstream& iss)
+	{
+		// Get a Color data form string stream
+		LowRenderer::Color color = { 0.f };
+
+		iss >> color.data.r;
+		iss >> color.data.g;
+		iss >> color.data.b;
+
+		return color;
+	}
+
+	std::vector<MaterialData> parse(std::istream& stream)
+	{
+		std::vector<MaterialData> materials;
+		std::string line;
+
+		while (std::getline(stream, line))
+		{
+			std::istringstream iss(line);
+			std::string type;
+			iss >> type;
+
+			if (type == "" || type[0] == '#')
+				continue;
+
+			if (type == "newmtl")
+			{
+				materials.emplace_back();
+				iss >> materials.back().name;
+				continue;
+			}
+
+			// Nothing to fill before the first material
+			if (materials.empty())
+				continue;
+
+			MaterialData& mat = materials.back();
+
+			if (type == "Ns")
+				iss >> mat.shininess;
+			else if (type == "Ka")
+				mat.ambient = getColor(iss);
+			else if (type == "Kd")
+				mat.diffuse = getColor(iss);
+			else if (type == "Ks")
+				mat.specular = getColor(iss);
+			else if (type == "Ke")
+				mat.emissive = getColor(iss);
+			else if (type == "Ni")
+				iss >> mat.opticalDensity;
+			else if (type == "d")
+				iss >> mat.transparency;
+			else if (type == "illum")
+				iss >> mat.illumination;
+			else if (type == "map_Ka")
+				iss >> mat.ambientTex;
+			else if (type == "map_Kd")
+				iss >> mat.diffuseTex;
+			else if (type == "map_Ks")
+				iss >> mat.specularTex;
+			else if (type == "map_Ke")
+				iss >> mat.emissiveTex;
+			else if (type == "map_d")
+				iss >> mat.alphaTex;
+		}
+
+		return materials;
+	}
+}
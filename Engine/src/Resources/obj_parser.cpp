@@ -0,0 +1,599 @@
+#include "obj_parser.hpp"
+
+#include <cstring>
+#include <climits>
+#include <algorithm>
+
+namespace Resources::Obj
+{
+	#pragma region ____TOKENIZER____
+
+	static const double powersOf10[] =
+	{
+		1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10,
+		1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	inline bool isSpace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\r';
+	}
+
+	inline bool isDigit(char c)
+	{
+		return (unsigned char)(c - '0') < 10;
+	}
+
+	inline const char* skipSpaces(const char* cur, const char* end)
+	{
+		while (cur < end && isSpace(*cur))
+			cur++;
+
+		return cur;
+	}
+
+	inline const char* findLineEnd(const char* cur, const char* end)
+	{
+		const char* lineEnd = (const char*)memchr(cur, '\n', end - cur);
+		return lineEnd ? lineEnd : end;
+	}
+
+	// Return the next space separated token of the line
+	inline std::string getToken(const char* cur, const char* end)
+	{
+		cur = skipSpaces(cur, end);
+
+		const char* tokenEnd = cur;
+		while (tokenEnd < end && !isSpace(*tokenEnd))
+			tokenEnd++;
+
+		return std::string(cur, tokenEnd);
+	}
+
+	// Check if the line starts with the keyword followed by a space
+	inline bool isKeyword(const char* cur, const char* end, const char* keyword, size_t length)
+	{
+		return (size_t)(end - cur) > length && memcmp(cur, keyword, length) == 0 && isSpace(cur[length]);
+	}
+
+	const char* parseFloat(const char* cur, const char* end, float& value)
+	{
+		cur = skipSpaces(cur, end);
+
+		bool isNegative = false;
+		if (cur < end && (*cur == '-' || *cur == '+'))
+		{
+			isNegative = *cur == '-';
+			cur++;
+		}
+
+		// Keep 19 significant digits at most (fits in 64 bits)
+		unsigned long long mantissa = 0;
+		int digitsCount = 0;
+		int exponent = 0;
+
+		for (; cur < end && isDigit(*cur); cur++)
+		{
+			if (digitsCount < 19)
+			{
+				mantissa = mantissa * 10 + (*cur - '0');
+				if (mantissa) digitsCount++;
+			}
+			else
+				exponent++;
+		}
+
+		if (cur < end && *cur == '.')
+		{
+			for (cur++; cur < end && isDigit(*cur); cur++)
+			{
+				if (digitsCount < 19)
+				{
+					mantissa = mantissa * 10 + (*cur - '0');
+					if (mantissa) digitsCount++;
+					exponent--;
+				}
+			}
+		}
+
+		if (cur < end && (*cur == 'e' || *cur == 'E'))
+		{
+			int expValue = 0;
+			cur = parseInt(cur + 1, end, expValue);
+
+			// Beyond the double range the result is 0 or infinite, the loops below stay short
+			exponent = (int)std::clamp((long long)exponent + expValue, -400LL, 400LL);
+		}
+
+		double result = (double)mantissa;
+
+		if (exponent < 0)
+		{
+			for (; exponent < -22; exponent += 22)
+				result /= powersOf10[22];
+			result /= powersOf10[-exponent];
+		}
+		else if (exponent > 0)
+		{
+			for (; exponent > 22; exponent -= 22)
+				result *= powersOf10[22];
+			result *= powersOf10[exponent];
+		}
+
+		value = (float)(isNegative ? -result : result);
+
+		return cur;
+	}
+
+	const char* parseInt(const char* cur, const char* end, int& value)
+	{
+		cur = skipSpaces(cur, end);
+
+		bool isNegative = false;
+		if (cur < end && (*cur == '-' || *cur == '+'))
+		{
+			isNegative = *cur == '-';
+			cur++;
+		}
+
+		// Saturated, a malformed digit run is still read until its end but never overflows
+		long long result = 0;
+		for (; cur < end && isDigit(*cur); cur++)
+		{
+			if (result <= INT_MAX)
+				result = result * 10 + (*cur - '0');
+		}
+
+		result = std::min(result, (long long)INT_MAX);
+
+		value = isNegative ? -(int)result : (int)result;
+
+		return cur;
+	}
+
+	#pragma endregion
+
+	#pragma region ____RECORDS____
+
+	inline void addData(std::vector<Core::Maths::vec3>& dataVector, const char* cur, const char* end)
+	{
+		Core::Maths::vec3 data = { 0.f };
+
+		cur = parseFloat(cur, end, data.x);
+		cur = parseFloat(cur, end, data.y);
+		parseFloat(cur, end, data.z);
+
+		dataVector.push_back(data);
+	}
+
+	// Convert an obj index to a 0-based one, negative indices are relative to the elements read so far
+	inline unsigned int resolveIndex(int index, size_t count, bool& isRelative)
+	{
+		isRelative = index < 0;
+
+		if (index > 0)
+			return (unsigned int)(index - 1);
+		else if (index < 0)
+			return (unsigned int)((long long)count + index);
+
+		return OBJ_MISSING_INDEX;
+	}
+
+	// Read one face corner in any of the v, v/vt, v//vn and v/vt/vn forms,
+	// relative gets a bit set for each of the v/vt/vn indices given as negative
+	inline const char* parseCorner(const char* cur, const char* end, const size_t counts[3], unsigned int corner[3], unsigned int& relative)
+	{
+		int index = 0;
+		bool isRelative = false;
+
+		corner[1] = OBJ_MISSING_INDEX;
+		corner[2] = OBJ_MISSING_INDEX;
+		relative = 0;
+
+		cur = parseInt(cur, end, index);
+		corner[0] = resolveIndex(index, counts[0], isRelative);
+		relative |= isRelative ? 1 : 0;
+
+		if (cur < end && *cur == '/')
+		{
+			cur++;
+
+			if (cur < end && *cur != '/' && !isSpace(*cur))
+			{
+				cur = parseInt(cur, end, index);
+				corner[1] = resolveIndex(index, counts[1], isRelative);
+				relative |= isRelative ? 2 : 0;
+			}
+
+			if (cur < end && *cur == '/')
+			{
+				cur = parseInt(cur + 1, end, index);
+				corner[2] = resolveIndex(index, counts[2], isRelative);
+				relative |= isRelative ? 4 : 0;
+			}
+		}
+
+		// Skip what is left of a malformed corner
+		while (cur < end && !isSpace(*cur))
+			cur++;
+
+		return cur;
+	}
+
+	inline bool isCornerStart(char c)
+	{
+		return isDigit(c) || c == '-' || c == '+';
+	}
+
+	// Add the face indices in a single pass, faces with more than 3 vertices are fan triangulated
+	inline void addFace(std::vector<unsigned int>& indices, const char* cur, const char* end, const size_t counts[3], std::vector<size_t>* relativeIndices)
+	{
+		unsigned int first[3], previous[3], current[3];
+		unsigned int firstRelative = 0, previousRelative = 0, currentRelative = 0;
+		int cornersCount = 0;
+
+		// A fan only needs the first and the previous corners, no scratch buffer whatever the corners count
+		auto pushCorner = [&](const unsigned int corner[3], unsigned int relative)
+		{
+			if (relativeIndices && relative)
+			{
+				for (size_t i = 0; i < 3; i++)
+				{
+					if (relative & (1 << i))
+						relativeIndices->push_back(indices.size() + i);
+				}
+			}
+
+			indices.insert(indices.end(), corner, corner + 3);
+		};
+
+		for (cur = skipSpaces(cur, end); cur < end && isCornerStart(*cur); cur = skipSpaces(cur, end))
+		{
+			cur = parseCorner(cur, end, counts, current, currentRelative);
+
+			if (cornersCount > 2)
+			{
+				pushCorner(first, firstRelative);
+				pushCorner(previous, previousRelative);
+			}
+
+			pushCorner(current, currentRelative);
+
+			if (cornersCount == 0)
+			{
+				memcpy(first, current, sizeof(first));
+				firstRelative = currentRelative;
+			}
+
+			memcpy(previous, current, sizeof(previous));
+			previousRelative = currentRelative;
+			cornersCount++;
+		}
+
+		// Not a face, don't leave a partial triangle in the indices
+		if (cornersCount > 0 && cornersCount < 3)
+		{
+			indices.resize(indices.size() - cornersCount * 3);
+
+			if (relativeIndices)
+			{
+				while (!relativeIndices->empty() && relativeIndices->back() >= indices.size())
+					relativeIndices->pop_back();
+			}
+		}
+	}
+
+	// Count the corners of a face line, without parsing them
+	inline size_t countCorners(const char* cur, const char* end)
+	{
+		size_t cornersCount = 0;
+
+		for (cur = skipSpaces(cur, end); cur < end && isCornerStart(*cur); cur = skipSpaces(cur, end))
+		{
+			while (cur < end && !isSpace(*cur))
+				cur++;
+
+			cornersCount++;
+		}
+
+		return cornersCount;
+	}
+
+	#pragma endregion
+
+	#pragma region ____GROUPS____
+
+	// Build the groups from the o/g/usemtl/mtllib keywords, in file order
+	class GroupBuilder
+	{
+	private:
+		Data& m_data;
+		// Held by value, the default ones are temporaries
+		MtlLibCallback m_onMtlLib;
+		GroupCallback m_onGroup;
+
+		Group group;
+		bool isFirstObject = true;
+
+		void closeGroup(size_t indicesPos)
+		{
+			group.indicesEnd = indicesPos;
+			m_data.groups.push_back(group);
+
+			if (m_onGroup)
+				m_onGroup(m_data.groups.back());
+		}
+
+	public:
+		GroupBuilder(Data& data, MtlLibCallback onMtlLib, GroupCallback onGroup = nullptr)
+			: m_data(data), m_onMtlLib(std::move(onMtlLib)), m_onGroup(std::move(onGroup)) {}
+
+		void onObject(const std::string& name, size_t indicesPos)
+		{
+			if (isFirstObject)
+				isFirstObject = false;
+			else
+			{
+				// Close the current group if it has faces
+				if (indicesPos > group.indicesBegin)
+					closeGroup(indicesPos);
+
+				group = Group();
+				group.indicesBegin = indicesPos;
+			}
+
+			group.name = name;
+		}
+
+		void onMaterial(const std::string& name)
+		{
+			group.matName = name;
+		}
+
+		void onMtlLib(const std::string& name)
+		{
+			m_data.mtlLibs.push_back(name);
+
+			if (m_onMtlLib)
+				m_onMtlLib(name);
+		}
+
+		void finish(size_t indicesCount)
+		{
+			if (indicesCount > group.indicesBegin)
+				closeGroup(indicesCount);
+		}
+	};
+
+	// Record the keywords of a chunk to replay them when merging
+	struct EventRecorder
+	{
+		std::vector<Event>& events;
+
+		void onObject(const std::string& name, size_t indicesPos)
+		{
+			events.push_back({ Event::Type::OBJECT, name, indicesPos });
+		}
+
+		void onMaterial(const std::string& name)
+		{
+			events.push_back({ Event::Type::MATERIAL, name, 0 });
+		}
+
+		void onMtlLib(const std::string& name)
+		{
+			events.push_back({ Event::Type::MTLLIB, name, 0 });
+		}
+	};
+
+	#pragma endregion
+
+	// Parse every line of the range, keywords are sent to the handler
+	// relativeIndices gets the positions of the negative indices when the range is not parsed from the file start
+	template <class Handler>
+	void parseLines(const char* begin, const char* end, std::vector<Core::Maths::vec3>& vertices, std::vector<Core::Maths::vec3>& texCoords,
+		std::vector<Core::Maths::vec3>& normals, std::vector<unsigned int>& indices, Handler& handler, std::vector<size_t>* relativeIndices = nullptr)
+	{
+		for (const char* cur = begin; cur < end;)
+		{
+			cur = skipSpaces(cur, end);
+
+			const char* lineEnd = findLineEnd(cur, end);
+
+			if (cur == lineEnd || *cur == '#')
+			{
+				cur = lineEnd + 1;
+				continue;
+			}
+
+			if (isKeyword(cur, lineEnd, "v", 1))
+				addData(vertices, cur + 1, lineEnd);
+			else if (isKeyword(cur, lineEnd, "vt", 2))
+				addData(texCoords, cur + 2, lineEnd);
+			else if (isKeyword(cur, lineEnd, "vn", 2))
+				addData(normals, cur + 2, lineEnd);
+			else if (isKeyword(cur, lineEnd, "f", 1))
+			{
+				const size_t counts[3] = { vertices.size(), texCoords.size(), normals.size() };
+				addFace(indices, cur + 1, lineEnd, counts, relativeIndices);
+			}
+			else if (isKeyword(cur, lineEnd, "o", 1) || isKeyword(cur, lineEnd, "g", 1))
+				handler.onObject(getToken(cur + 1, lineEnd), indices.size());
+			else if (isKeyword(cur, lineEnd, "usemtl", 6))
+				handler.onMaterial(getToken(cur + 6, lineEnd));
+			else if (isKeyword(cur, lineEnd, "mtllib", 6))
+				handler.onMtlLib(getToken(cur + 6, lineEnd));
+
+			cur = lineEnd + 1;
+		}
+	}
+
+	void parseFace(const char* begin, const char* end, size_t verticesCount, size_t texCoordsCount, size_t normalsCount, std::vector<unsigned int>& indices)
+	{
+		const size_t counts[3] = { verticesCount, texCoordsCount, normalsCount };
+		addFace(indices, begin, end, counts, nullptr);
+	}
+
+	Counts count(const char* begin, const char* end)
+	{
+		Counts counts;
+
+		for (const char* cur = begin; cur < end;)
+		{
+			cur = skipSpaces(cur, end);
+
+			const char* lineEnd = findLineEnd(cur, end);
+
+			if (isKeyword(cur, lineEnd, "v", 1))
+				counts.vertices++;
+			else if (isKeyword(cur, lineEnd, "vt", 2))
+				counts.texCoords++;
+			else if (isKeyword(cur, lineEnd, "vn", 2))
+				counts.normals++;
+			else if (isKeyword(cur, lineEnd, "f", 1))
+			{
+				// Fan triangulation: (n - 2) triangles of 3 v/vt/vn triplets
+				size_t cornersCount = countCorners(cur + 1, lineEnd);
+				if (cornersCount > 2)
+					counts.indices += (cornersCount - 2) * 9;
+			}
+
+			cur = lineEnd + 1;
+		}
+
+		return counts;
+	}
+
+	// Reserve the exact capacities, no regrowth (and no doubled capacity) while parsing
+	static void reserve(const Counts& counts, std::vector<Core::Maths::vec3>& vertices, std::vector<Core::Maths::vec3>& texCoords,
+		std::vector<Core::Maths::vec3>& normals, std::vector<unsigned int>& indices)
+	{
+		vertices.reserve(vertices.size() + counts.vertices);
+		texCoords.reserve(texCoords.size() + counts.texCoords);
+		normals.reserve(normals.size() + counts.normals);
+		indices.reserve(indices.size() + counts.indices);
+	}
+
+	void parse(const char* begin, const char* end, Data& data, const MtlLibCallback& onMtlLib, const GroupCallback& onGroup)
+	{
+		GroupBuilder builder(data, onMtlLib, onGroup);
+
+		reserve(count(begin, end), data.vertices, data.texCoords, data.normals, data.indices);
+
+		parseLines(begin, end, data.vertices, data.texCoords, data.normals, data.indices, builder);
+
+		builder.finish(data.indices.size());
+	}
+
+	std::vector<Chunk> split(const char* begin, const char* end, size_t chunksCount)
+	{
+		std::vector<Chunk> chunks;
+
+		if (chunksCount == 0)
+			chunksCount = 1;
+
+		size_t chunkSize = (end - begin) / chunksCount;
+
+		for (const char* cur = begin; cur < end;)
+		{
+			Chunk chunk;
+			chunk.begin = cur;
+
+			// Cut after the next new line so no record is split between two chunks
+			if (chunks.size() + 1 == chunksCount || (size_t)(end - cur) <= chunkSize)
+				chunk.end = end;
+			else
+			{
+				chunk.end = findLineEnd(cur + chunkSize, end);
+				if (chunk.end < end)
+					chunk.end++;
+			}
+
+			cur = chunk.end;
+			chunks.push_back(std::move(chunk));
+		}
+
+		return chunks;
+	}
+
+	void parseChunk(Chunk& chunk)
+	{
+		EventRecorder recorder = { chunk.events };
+
+		reserve(count(chunk.begin, chunk.end), chunk.vertices, chunk.texCoords, chunk.normals, chunk.indices);
+
+		parseLines(chunk.begin, chunk.end, chunk.vertices, chunk.texCoords, chunk.normals, chunk.indices, recorder, &chunk.relativeIndices);
+	}
+
+	void prepareMerge(std::vector<Chunk>& chunks, Data& data)
+	{
+		// Prefix sum of the chunks sizes give where each chunk lands in the merged data
+		size_t verticesCount = 0, texCoordsCount = 0, normalsCount = 0, indicesCount = 0;
+
+		for (Chunk& chunk : chunks)
+		{
+			chunk.verticesOffset = verticesCount;
+			chunk.texCoordsOffset = texCoordsCount;
+			chunk.normalsOffset = normalsCount;
+			chunk.indicesOffset = indicesCount;
+
+			verticesCount += chunk.vertices.size();
+			texCoordsCount += chunk.texCoords.size();
+			normalsCount += chunk.normals.size();
+			indicesCount += chunk.indices.size();
+		}
+
+		data.vertices.resize(verticesCount);
+		data.texCoords.resize(texCoordsCount);
+		data.normals.resize(normalsCount);
+		data.indices.resize(indicesCount);
+	}
+
+	void mergeChunk(Chunk& chunk, Data& data)
+	{
+		// Negative indices were resolved against the chunk data only, move them to the merged data
+		const size_t offsets[3] = { chunk.verticesOffset, chunk.texCoordsOffset, chunk.normalsOffset };
+		for (size_t pos : chunk.relativeIndices)
+			chunk.indices[pos] += (unsigned int)offsets[pos % 3];
+
+		// Chunks write in disjoint ranges, can be done in parallel
+		std::copy(chunk.vertices.begin(), chunk.vertices.end(), data.vertices.begin() + chunk.verticesOffset);
+		std::copy(chunk.texCoords.begin(), chunk.texCoords.end(), data.texCoords.begin() + chunk.texCoordsOffset);
+		std::copy(chunk.normals.begin(), chunk.normals.end(), data.normals.begin() + chunk.normalsOffset);
+		std::copy(chunk.indices.begin(), chunk.indices.end(), data.indices.begin() + chunk.indicesOffset);
+
+		// Free the chunk memory as soon as possible
+		chunk.vertices = std::vector<Core::Maths::vec3>();
+		chunk.texCoords = std::vector<Core::Maths::vec3>();
+		chunk.normals = std::vector<Core::Maths::vec3>();
+		chunk.indices = std::vector<unsigned int>();
+		chunk.relativeIndices = std::vector<size_t>();
+	}
+
+	void mergeGroups(const std::vector<Chunk>& chunks, Data& data, const MtlLibCallback& onMtlLib)
+	{
+		GroupBuilder builder(data, onMtlLib);
+
+		// Replay the keywords in file order with their merged positions
+		for (const Chunk& chunk : chunks)
+		{
+			for (const Event& event : chunk.events)
+			{
+				switch (event.type)
+				{
+				case Event::Type::OBJECT:
+					builder.onObject(event.name, chunk.indicesOffset + event.indicesPos);
+					break;
+				case Event::Type::MATERIAL:
+					builder.onMaterial(event.name);
+					break;
+				case Event::Type::MTLLIB:
+					builder.onMtlLib(event.name);
+					break;
+				}
+			}
+		}
+
+		builder.finish(data.indices.size());
+	}
+}
@@ -4,6 +4,12 @@
 #include <sstream>
 #include <filesystem>
 
+#include "mapped_file.hpp"
+#include "mesh_cache.hpp"
+#include "texture_streamer.hpp"
+#include "material_cache.hpp"
+#include "mtl_parser.hpp"
+#include "obj_parser.hpp"
 #include "define.hpp"
 #include "debug.hpp"
 
@@ -28,114 +34,46 @@ namespace Resources
 		dataVector.push_back(data);
 	}
 
-	LowRenderer::Color getColor(std::istringstream& iss)
+	// Pre-scan the obj records to reserve the exact capacities instead of growing the vectors
+	void reserveObjData(const std::string& filePath, std::vector<Core::Maths::vec3>& vertices, std::vector<Core::Maths::vec3>& texCoords,
+		std::vector<Core::Maths::vec3>& normals, std::vector<unsigned int>& indices)
 	{
-		// Get a Color data form string stream
-		LowRenderer::Color color = { 0.f };
+		Utils::MappedFile dataObj(PROJECT_DIR + filePath);
+		if (!dataObj.isOpen())
+			return;
 
-		iss >> color.data.r;
-		iss >> color.data.g;
-		iss >> color.data.b;
+		Resources::Obj::Counts counts = Resources::Obj::count(dataObj.data(), dataObj.end());
 
-		return color;
+		vertices.reserve(counts.vertices);
+		texCoords.reserve(counts.texCoords);
+		normals.reserve(counts.normals);
+		indices.reserve(counts.indices);
 	}
 
-	// Use to know if needed to triangulate faces
-	int getNumFace(const std::string& line)
+	// Material written by this mtl parsing, a throwaway one if another mtl already wrote it
+	std::shared_ptr<Material> claimMaterial(const std::string& matName)
 	{
-		int numFace = 0;
-
-		// Check how many spaces the line has
-		for (size_t i = 0; i < line.length(); i++)
-		{
-			if (line[i] == ' ')
-				numFace++;
-		}
-
-		return numFace;
-	}
-
-	// Give the number of vertices of a face from an .obj
-	int numVerticesFace(const std::string& line)
-	{
-		int numV = 0;
-
-		for (size_t i = 0; i < line.length(); i++)
-		{
-			if (line[i] == '/')
-				numV++;
-		}
+		std::shared_ptr<Material> mat = ResourcesManager::loadMaterial(matName);
 
-		if (numV > 6)
-			return 4;
-		else
-			return 3;
+		return mat->claim() ? mat : std::make_shared<Material>();
 	}
 
-	// Allow to know if face is of type v//vn or v/uv/vn
-	int getFaceType(const std::string& line)
+	// Every field is written, the material can be drawn
+	void publishMaterial(const std::shared_ptr<Material>& mat)
 	{
-		for (size_t i = 3; i < line.length(); i++)
-		{
-			if (line[i - 1] == '/' && line[i] == '/')
-				return 1;
-		}
-
-		return 0;
+		mat->isDrawable.store(true, std::memory_order_release);
 	}
 
-	void addIndices(std::vector<unsigned int>& indices, std::istringstream& iss, const std::string& line)
+	// Faces of any size and index form, negative indices are resolved against the data read so far
+	void addIndices(std::vector<unsigned int>& indices, std::istringstream& iss, const std::string& line,
+		const std::vector<Core::Maths::vec3>& vertices, const std::vector<Core::Maths::vec3>& texCoords, const std::vector<Core::Maths::vec3>& normals)
 	{
-		unsigned int indicesVertices[4];
-		unsigned int indicesUV[4];
-		unsigned int indicesNormals[4];
-
-		// Number of vertices of the face 
-		int numV = numVerticesFace(line);
-
-		// Data type of the face
-		int type = getFaceType(line);
-
-		for (int i = 0; i < numV; i++)
-		{
-			// Face of type v/uv/vn
-			if (type == 0)
-			{
-				iss >> indicesVertices[i];
-				iss.ignore();
-				iss >> indicesUV[i];
-				iss.ignore();
-				iss >> indicesNormals[i];
-				iss.ignore();
-			}
-			// Face of type v//vn
-			else
-			{
-				iss >> indicesVertices[i];
-				iss.ignore();
-				iss.ignore();
-				iss >> indicesNormals[i];
-
-				indicesUV[i] = 1;
-			}
-
-			int indexV2Strip = i;
-			// Strip faces (triangulation)
-			if (i > 2)
-			{
-				indices.push_back(indicesVertices[0] - 1);
-				indices.push_back(indicesUV[0] - 1);
-				indices.push_back(indicesNormals[0] - 1);
-				indices.push_back(indicesVertices[i - 1] - 1);
-				indices.push_back(indicesUV[i - 1] - 1);
-				indices.push_back(indicesNormals[i - 1] - 1);
-			}
+		// The corners are read in one pass from where the stream stopped after the keyword
+		std::streamoff pos = iss.tellg();
+		if (pos < 0)
+			return;
 
-			// Add vertex indices to the mesh indices
-			indices.push_back(indicesVertices[i] - 1);
-			indices.push_back(indicesUV[i] - 1);
-			indices.push_back(indicesNormals[i] - 1);
-		}
+		Obj::parseFace(line.data() + pos, line.data() + line.size(), vertices.size(), texCoords.size(), normals.size(), indices);
 	}
 
 #pragma endregion
@@ -222,6 +160,7 @@ namespace Resources
 		loadShaderProgram("skyBox", "resources/shaders/skyBox.vert", "resources/shaders/skyBox.frag");
 		loadShaderProgram("colliderShader", "resources/shaders/vertexCollider.vert", "resources/shaders/fragmentCollider.frag");
 		loadShaderProgram("spriteShader", "resources/shaders/spriteVertex.vert", "resources/shaders/spriteFragment.frag");
+		loadShaderProgram("textShader", "resources/shaders/textShader.vert", "resources/shaders/textShader.frag");
 		loadShaderProgram("depthShader", "resources/shaders/depthShader.vert", "resources/shaders/depthShader.frag");
 		loadShaderProgram("depthCubeShader", "resources/shaders/depthCubeShader.vert", "resources/shaders/depthShader.frag", "resources/shaders/depthCubeShader.geom");
 
@@ -242,6 +181,15 @@ namespace Resources
 		RM->clearMap(RM->materials);
 		RM->clearMap(RM->cubeMaps);
 		RM->clearMap(RM->textures);
+		RM->clearMap(RM->fonts);
+
+		for (auto it = RM->textureContents.begin(); it != RM->textureContents.end();)
+		{
+			if (it->second.expired())
+				it = RM->textureContents.erase(it);
+			else
+				it++;
+		}
 	}
 
 	std::shared_ptr<Shader> ResourcesManager::loadShader(const std::string& shaderPath)
@@ -272,24 +220,66 @@ namespace Resources
 		return RM->shaderPrograms[programName] = std::make_shared<ShaderProgram>(programName, vertPath, fragPath, geomPath);
 	}
 
-	std::shared_ptr<Font> ResourcesManager::loadFont(const std::string& fontPath)
+	std::shared_ptr<Font> ResourcesManager::loadFont(const std::string& fontPath, bool isMultiThreaded)
 	{
 		ResourcesManager* RM = instance();
 
-		const auto& fontIt = RM->fonts.find(fontPath);
+		std::string absPath = PROJECT_DIR + fontPath;
 
-		// Check if the Texture is already loaded
+		while (RM->lockFonts.test_and_set());
+
+		const auto& fontIt = RM->fonts.find(absPath);
+
+		// Check if the Font is already loaded
 		if (fontIt != RM->fonts.end())
 		{
-			return fontIt->second;
+			auto font = fontIt->second;
+			RM->lockFonts.clear();
+
+			// Wait for it if its atlas is not uploaded yet
+			font->loadWaiters.add(RM->getSceneLoadHandle(), LoadHandle::JobType::TEXTURE);
+			font->loadWaiters.addEvent(RM->addUploadEvent("Font " + fontPath + " upload"));
+
+			return font;
 		}
 
-		return RM->fonts[fontPath] = std::make_shared<Font>(Font(fontPath));
+		RM->fonts[absPath] = std::make_shared<Font>();
+		auto font = RM->fonts[absPath];
+
+		RM->lockFonts.clear();
+
+		font->m_name = fontPath;
+		font->loadWaiters.add(RM->getSceneLoadHandle(), LoadHandle::JobType::TEXTURE);
+
+		// The glyphs are rasterized and packed on a loading thread, the atlas is uploaded once
+		bool isOnRequest = isMultiThreaded || RM->bench->isActive();
+		RM->startLoading("Font " + fontPath, [font = font.get(), absPath, isOnRequest]() { font->create(absPath, isOnRequest); },
+			isMultiThreaded, &font->loadWaiters);
+
+		return font;
 	}
 
 	void ResourcesManager::clearTextures()
 	{
 		instance()->textures.clear();
+		instance()->textureContents.clear();
+	}
+
+	std::shared_ptr<Texture> ResourcesManager::shareTextureContent(uint64_t contentHash, const std::shared_ptr<Texture>& texture)
+	{
+		ResourcesManager* RM = instance();
+
+		while (RM->lockTextures.test_and_set());
+
+		std::weak_ptr<Texture>& first = RM->textureContents[contentHash];
+
+		std::shared_ptr<Texture> sameTexture = first.lock();
+		if (!sameTexture)
+			first = texture;
+
+		RM->lockTextures.clear();
+
+		return sameTexture != texture ? sameTexture : nullptr;
 	}
 
 	std::shared_ptr<Texture> ResourcesManager::loadTexture(const std::string& texName, int width, int height, float* data)
@@ -321,7 +311,7 @@ namespace Resources
 		return tex;
 	}
 
-	std::shared_ptr<Texture> ResourcesManager::loadTexture(const std::string& texName, bool isMultiThreaded)
+	std::shared_ptr<Texture> ResourcesManager::loadTexture(const std::string& texName, bool isMultiThreaded, const std::shared_ptr<LoadHandle>& loadHandle)
 	{
 		ResourcesManager* RM = instance();
 
@@ -335,8 +325,14 @@ namespace Resources
 		if (textureIt != RM->textures.end())
 		{
 			//Core::Debug::Log::info("Texture " + texName + " is already loaded");
+			auto tex = textureIt->second;
 			RM->lockTextures.clear();
-			return textureIt->second;
+
+			// Wait for it if its upload is not done yet
+			tex->loadWaiters.add(loadHandle ? loadHandle : RM->getSceneLoadHandle(), LoadHandle::JobType::TEXTURE);
+			tex->loadWaiters.addEvent(RM->addUploadEvent("Texture " + texName + " upload"));
+
+			return tex;
 		}
 
 		// Get texture (avoid reading when returning)
@@ -345,14 +341,64 @@ namespace Resources
 
 		RM->lockTextures.clear();
 
-		if (isMultiThreaded)
-			ThreadPool::addTask(std::bind(&Texture::create, tex.get(), absPath, true));
-		else
-			tex->create(absPath, RM->bench->isActive());
+		tex->loadWaiters.add(loadHandle ? loadHandle : RM->getSceneLoadHandle(), LoadHandle::JobType::TEXTURE);
+
+		bool isOnRequest = isMultiThreaded || RM->bench->isActive();
+		bool useCache = RM->useTextureCache;
+		bool isStreamed = TextureStreamer::isStreamingEnabled();
+		RM->startLoading("Texture " + texName, [texture = tex.get(), absPath, isOnRequest, useCache, isStreamed]()
+		{
+			texture->create(absPath, isOnRequest, useCache, isStreamed);
+		}, isMultiThreaded, &tex->loadWaiters);
 
 		return tex;
 	}
 
+	std::shared_ptr<AtlasRegion> ResourcesManager::loadAtlasRegion(const std::string& imageName, bool isMultiThreaded, const std::shared_ptr<LoadHandle>& loadHandle)
+	{
+		ResourcesManager* RM = instance();
+
+		std::string absPath = PROJECT_DIR + imageName;
+
+		while (RM->lockAtlasRegions.test_and_set());
+
+		const auto& regionIt = RM->atlasRegions.find(absPath);
+
+		// Check if the image is already packed
+		if (regionIt != RM->atlasRegions.end())
+		{
+			auto region = regionIt->second;
+			RM->lockAtlasRegions.clear();
+
+			// Wait for it if its upload is not done yet
+			region->loadWaiters.add(loadHandle ? loadHandle : RM->getSceneLoadHandle(), LoadHandle::JobType::TEXTURE);
+			region->loadWaiters.addEvent(RM->addUploadEvent("Atlas region " + imageName + " upload"));
+
+			return region;
+		}
+
+		// Only the header is read, the big images keep their own texture
+		if (!TextureAtlas::fits(absPath))
+		{
+			RM->lockAtlasRegions.clear();
+			return nullptr;
+		}
+
+		RM->atlasRegions[absPath] = std::make_shared<AtlasRegion>();
+		auto region = RM->atlasRegions[absPath];
+
+		RM->lockAtlasRegions.clear();
+
+		region->imagePath = imageName;
+		region->loadWaiters.add(loadHandle ? loadHandle : RM->getSceneLoadHandle(), LoadHandle::JobType::TEXTURE);
+
+		bool isOnRequest = isMultiThreaded || RM->bench->isActive();
+		RM->startLoading("Atlas region " + imageName, [region, absPath, isOnRequest]() { TextureAtlas::add(region, absPath, isOnRequest); },
+			isMultiThreaded, &region->loadWaiters);
+
+		return region;
+	}
+
 	std::shared_ptr<CubeMap> ResourcesManager::loadCubeMap(const std::vector<std::string>& cubeMapPaths, bool isMulti)
 	{
 		ResourcesManager* RM = instance();
@@ -369,8 +415,13 @@ namespace Resources
 		// Check if the Texture is already loaded
 		if (cubeMapIt != RM->cubeMaps.end())
 		{
+			auto cubeMap = cubeMapIt->second;
 			RM->lockCubeMaps.clear();
-			return cubeMapIt->second;
+
+			cubeMap->loadWaiters.add(RM->getSceneLoadHandle(), LoadHandle::JobType::TEXTURE);
+			cubeMap->loadWaiters.addEvent(RM->addUploadEvent("Cube map " + pathsDir + " upload"));
+
+			return cubeMap;
 		}
 
 		RM->cubeMaps[pathsDir] = std::make_shared<CubeMap>();
@@ -379,12 +430,17 @@ namespace Resources
 
 		RM->lockCubeMaps.clear();
 
+		cubeMap->loadWaiters.add(RM->getSceneLoadHandle(), LoadHandle::JobType::TEXTURE);
+
 		Core::Debug::Log::info("Start creating skybox at " + pathsDir);
 
+		// The faces are decoded by their own tasks of the scene graph, the skybox is not one long task anymore
+		std::shared_ptr<Core::TaskGroup> tasks = RM->sceneTasks && !RM->sceneTasks->isDone() ? RM->sceneTasks : nullptr;
+
 		if (isMulti)
-			ThreadPool::addTask(std::bind(&CubeMap::create, cubeMap.get(), cubeMapPaths, true));
+			cubeMap->create(cubeMapPaths, true, true, RM->useTextureCache, tasks);
 		else
-			cubeMap->create(cubeMapPaths, RM->bench->isActive());
+			cubeMap->create(cubeMapPaths, false, RM->bench->isActive(), RM->useTextureCache, tasks);
 
 		return cubeMap;
 	}
@@ -442,14 +498,362 @@ namespace Resources
 		Core::Engine::Benchmark::addModelsCount(1);
 
 		// Create the model and set model ptr
-		RM->models[filePath] = std::make_shared<LowRenderer::Model>(LowRenderer::Model(filePath));
+		std::shared_ptr<LowRenderer::Model> model = RM->models[filePath] = std::make_shared<LowRenderer::Model>(LowRenderer::Model(filePath));
+
+		// Track the model jobs, the handle is completed once everything is uploaded
+		std::shared_ptr<LoadHandle> loadHandle = std::make_shared<LoadHandle>(RM->getSceneLoadHandle(), &Core::Engine::Benchmark::addModelLoading);
+		model->setLoadHandle(loadHandle);
+
+		bool onBenchmark = RM->bench->isActive();
+		ObjParserType parserType = RM->objParser;
+
+		// The loading task ends the LOADING job of the handle, whatever the parser
+		auto load = [RM, filePath, model, loadHandle, isMulti, onBenchmark, parserType]()
+		{
+			if (parserType == ObjParserType::MAPPED)
+				RM->loadObjMapped(filePath, model, isMulti, !isMulti && onBenchmark);
+			else if (isMulti)
+				RM->loadObjMulti(filePath);
+			else
+				RM->loadObjMono(filePath, onBenchmark);
+
+			loadHandle->endJob(LoadHandle::JobType::LOADING);
+		};
+
+		RM->startLoading("Obj " + filePath, load, isMulti);
+
+		return model;
+	}
+
+	void ResourcesManager::setObjParser(ObjParserType parserType)
+	{
+		instance()->objParser = parserType;
+	}
+
+	ObjParserType ResourcesManager::getObjParser()
+	{
+		return instance()->objParser;
+	}
+
+	void ResourcesManager::setMeshCache(bool isEnabled)
+	{
+		instance()->useMeshCache = isEnabled;
+	}
+
+	bool ResourcesManager::isMeshCacheEnabled()
+	{
+		return instance()->useMeshCache;
+	}
+
+	void ResourcesManager::setTextureCache(bool isEnabled)
+	{
+		instance()->useTextureCache = isEnabled;
+	}
+
+	bool ResourcesManager::isTextureCacheEnabled()
+	{
+		return instance()->useTextureCache;
+	}
+
+	void ResourcesManager::setVertexLayout(VertexLayout layout)
+	{
+		instance()->vertexLayout = layout;
+	}
+
+	VertexLayout ResourcesManager::getVertexLayout()
+	{
+		return instance()->vertexLayout;
+	}
+
+	void ResourcesManager::setSceneLoadHandle(const std::shared_ptr<LoadHandle>& loadHandle)
+	{
+		instance()->sceneLoadHandle = loadHandle;
+	}
+
+	thread_local std::shared_ptr<LoadHandle> ResourcesManager::threadLoadHandle = nullptr;
+
+	void ResourcesManager::setThreadLoadHandle(const std::shared_ptr<LoadHandle>& loadHandle)
+	{
+		threadLoadHandle = loadHandle;
+	}
+
+	std::shared_ptr<LoadHandle> ResourcesManager::getSceneLoadHandle() const
+	{
+		return threadLoadHandle ? threadLoadHandle : sceneLoadHandle;
+	}
+
+	void ResourcesManager::setSceneTasks(const std::shared_ptr<Core::TaskGroup>& tasks)
+	{
+		instance()->sceneTasks = tasks;
+	}
+
+	void ResourcesManager::startLoading(const std::string& name, TaskFunction loading, bool isMulti, LoadWaiters* waiters)
+	{
+		std::shared_ptr<Core::TaskGroup> tasks = sceneTasks;
+
+		// Requested once the scene is loaded (instantiation), not part of its graph
+		if (!tasks || tasks->isDone())
+		{
+			if (isMulti)
+				ThreadPool::addTask(std::move(loading));
+			else
+				loading();
+
+			return;
+		}
+
+		std::shared_ptr<Core::Task> task = tasks->add(name, std::move(loading), isMulti);
+
+		if (waiters)
+		{
+			// Set before the loading starts, it can release its waiters right away
+			std::shared_ptr<Core::Task> uploaded = tasks->addEvent(name + " upload");
+			uploaded->after(task);
+			uploaded->submit();
+
+			waiters->addEvent(uploaded);
+		}
+
+		task->submit();
+	}
+
+	std::shared_ptr<Core::Task> ResourcesManager::addUploadEvent(const std::string& name)
+	{
+		std::shared_ptr<Core::TaskGroup> tasks = sceneTasks;
+
+		if (!tasks || tasks->isDone())
+			return nullptr;
+
+		std::shared_ptr<Core::Task> uploaded = tasks->addEvent(name);
+		uploaded->submit();
+
+		return uploaded;
+	}
+
+	void ResourcesManager::loadMtlLib(const std::string& dirPath, const std::string& mtlName, bool isMulti, const std::shared_ptr<LoadHandle>& loadHandle)
+	{
+		loadHandle->addJob(LoadHandle::JobType::MATERIAL);
+
+		// Load mtl file
+		startLoading("Mtl " + dirPath + mtlName, [this, dirPath, mtlName, isMulti, loadHandle]()
+		{
+			loadMaterialsFromMtl(dirPath, mtlName, isMulti, loadHandle);
+			loadHandle->endJob(LoadHandle::JobType::MATERIAL);
+		}, isMulti);
+	}
+
+	std::shared_ptr<Mesh> ResourcesManager::addMesh(const std::shared_ptr<LowRenderer::Model>& model, Mesh&& mesh, const std::string& matName, bool isMulti, bool onBenchmark)
+	{
+		// Move the mesh buffers in the shared mesh, no copy of the attributs
+		std::shared_ptr<Mesh> meshPtr = std::make_shared<Mesh>(std::move(mesh));
+
+		while (lockMeshes.test_and_set());
+
+		// Add the mesh on RM
+		meshes[meshPtr->name] = meshPtr;
+
+		lockMeshes.clear();
+
+		// The mesh job ends once its VAO is generated
+		std::shared_ptr<LoadHandle> loadHandle = model->getLoadHandle();
+		loadHandle->addJob(LoadHandle::JobType::MESH);
+
+		std::shared_ptr<Material> material = loadMaterial(matName);
+
+		std::shared_ptr<Core::Task> uploaded = addUploadEvent("Mesh " + meshPtr->name + " upload");
 
 		if (isMulti)
-			ThreadPool::addTask(std::bind(&ResourcesManager::loadObjMulti, RM, filePath));
+		{
+			// Link mesh and material to the model
+			Core::Engine::Graph::addRequest([model, meshPtr, material, loadHandle, uploaded]()
+			{
+				model->addSubModel(meshPtr, material);
+				loadHandle->endJob(LoadHandle::JobType::MESH);
+
+				if (uploaded)
+					uploaded->end();
+			});
+		}
+		else if (onBenchmark)
+		{
+			// Link mesh and material to the model
+			model->m_subModels.push_back(LowRenderer::SubModel(meshPtr, material));
+
+			// Generate VAO
+			Core::Engine::Graph::addRequest([meshPtr, loadHandle, uploaded]()
+			{
+				meshPtr->generateVAO();
+				loadHandle->endJob(LoadHandle::JobType::MESH);
+
+				if (uploaded)
+					uploaded->end();
+			});
+		}
 		else
-			RM->loadObjMono(filePath, RM->bench->isActive());
+		{
+			model->addSubModel(meshPtr, material);
+			loadHandle->endJob(LoadHandle::JobType::MESH);
 
-		return RM->models[filePath];
+			if (uploaded)
+				uploaded->end();
+		}
+
+		return meshPtr;
+	}
+
+	bool ResourcesManager::loadObjFromCache(const std::string& filePath, const std::shared_ptr<LowRenderer::Model>& model, bool isMulti, bool onBenchmark)
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		MeshCache::CachedModel cachedModel;
+
+		if (!MeshCache::read(filePath, vertexLayout, cachedModel))
+			return false;
+
+		Core::Debug::Log::info("Loading obj " + filePath + " from its mesh cache");
+
+		std::string dirPath = Utils::getDirectory(filePath);
+
+		for (const std::string& mtlName : cachedModel.mtlLibs)
+			loadMtlLib(dirPath, mtlName, isMulti, model->getLoadHandle());
+
+		for (const MeshCache::SubMesh& subMesh : cachedModel.subMeshes)
+		{
+			// The vertices are uploaded from the mapping, no parsing and no copy
+			Mesh mesh;
+			mesh.name = subMesh.name;
+			mesh.verticesCount = subMesh.verticesCount;
+			mesh.indicesCount = subMesh.indicesCount;
+			mesh.sourceVerticesCount = subMesh.sourceVerticesCount;
+			mesh.indexSize = subMesh.indexSize;
+			mesh.layout = vertexLayout;
+			mesh.setCachedData(cachedModel.file, subMesh.attributs, subMesh.attributsSize, subMesh.indices);
+
+			addMesh(model, std::move(mesh), subMesh.matName, isMulti, onBenchmark);
+		}
+
+		auto end = std::chrono::steady_clock::now();
+		long long microseconds = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+		Core::Engine::Benchmark::addMeshCacheLoading(cachedModel.file->size(), microseconds);
+
+		return true;
+	}
+
+	void ResourcesManager::loadObjMapped(const std::string& filePath, std::shared_ptr<LowRenderer::Model> model, bool isMulti, bool onBenchmark)
+	{
+		if (useMeshCache && loadObjFromCache(filePath, model, isMulti, onBenchmark))
+			return;
+
+		Utils::MappedFile dataObj(PROJECT_DIR + filePath);
+
+		// Check if the file exists
+		if (!dataObj.isOpen())
+		{
+			Core::Debug::Log::error("Unable to read the file : " + filePath);
+			return;
+		}
+
+		auto start = std::chrono::steady_clock::now();
+
+		Core::Debug::Log::info("Start loading obj " + filePath);
+
+		std::string dirPath = Utils::getDirectory(filePath);
+
+		auto loadMtl = [&](const std::string& mtlName) { loadMtlLib(dirPath, mtlName, isMulti, model->getLoadHandle()); };
+
+		Obj::Data data;
+
+		// Meshes of the groups, in file order for the cache
+		std::vector<std::shared_ptr<Mesh>> groupMeshes;
+
+		// Compute the mesh of a group and hand it off right away, its upload overlaps the rest of the loading
+		auto addGroupMesh = [&](const Obj::Group& group)
+		{
+			Mesh mesh;
+			mesh.name = group.name;
+			mesh.compute(data.vertices, data.texCoords, data.normals, data.indices.data() + group.indicesBegin, group.indicesEnd - group.indicesBegin, vertexLayout);
+
+			return addMesh(model, std::move(mesh), group.matName, isMulti, onBenchmark);
+		};
+
+		size_t chunksCount = std::min((size_t)ThreadPool::getThreadsCount(), dataObj.size() / OBJ_CHUNK_MIN_SIZE);
+
+		if (isMulti && chunksCount > 1)
+		{
+			// Big file, parse it by chunks on all the workers
+			std::vector<Obj::Chunk> chunks = Obj::split(dataObj.data(), dataObj.end(), chunksCount);
+
+			ThreadPool::parallelFor(chunks.size(), [&](size_t i) { Obj::parseChunk(chunks[i]); });
+
+			Obj::prepareMerge(chunks, data);
+			ThreadPool::parallelFor(chunks.size(), [&](size_t i) { Obj::mergeChunk(chunks[i], data); });
+			Obj::mergeGroups(chunks, data, loadMtl);
+
+			// The groups are known once merged, compute them on all the workers
+			groupMeshes.resize(data.groups.size());
+			ThreadPool::parallelFor(data.groups.size(), [&](size_t i) { groupMeshes[i] = addGroupMesh(data.groups[i]); });
+		}
+		else
+		{
+			// Each group is computed and handed off as soon as the parser closes it
+			Obj::parse(dataObj.data(), dataObj.end(), data, loadMtl, [&](const Obj::Group& group)
+			{
+				groupMeshes.push_back(addGroupMesh(group));
+			});
+		}
+
+		if (useMeshCache)
+		{
+			std::vector<MeshCache::SubMesh> subMeshes;
+
+			// Copy of the attributs then the indices of each submesh: the writer never holds the meshes, the last reference
+			// would release their GL buffers on a worker
+			std::vector<unsigned char> bytes;
+
+			for (size_t i = 0; i < groupMeshes.size(); i++)
+			{
+				const std::shared_ptr<Mesh>& mesh = groupMeshes[i];
+
+				subMeshes.push_back({ mesh->name, data.groups[i].matName, mesh->verticesCount, mesh->indicesCount, mesh->sourceVerticesCount,
+					mesh->indexSize, nullptr, mesh->attributs.size(), nullptr });
+
+				// Attributs are not modified after the compute, safe to read while the VAOs are generated
+				bytes.insert(bytes.end(), mesh->attributs.begin(), mesh->attributs.end());
+				bytes.insert(bytes.end(), mesh->indices.begin(), mesh->indices.end());
+			}
+
+			auto writeCache = [filePath, layout = vertexLayout, mtlLibs = data.mtlLibs, subMeshes = std::move(subMeshes), bytes = std::move(bytes)]() mutable
+			{
+				// Point in the copy once it is in its final place
+				const unsigned char* current = bytes.data();
+				for (MeshCache::SubMesh& subMesh : subMeshes)
+				{
+					subMesh.attributs = current;
+					subMesh.indices = current + subMesh.attributsSize;
+					current += subMesh.attributsSize + (size_t)subMesh.indicesCount * subMesh.indexSize;
+				}
+
+				if (!MeshCache::write(filePath, layout, mtlLibs, subMeshes))
+					Core::Debug::Log::warning("Unable to write the mesh cache of " + filePath);
+			};
+
+			// Only needed by the next loading, never delays this one
+			if (isMulti)
+				ThreadPool::addTask(std::move(writeCache), TaskPriority::BACKGROUND);
+			else
+				writeCache();
+		}
+
+		Core::Debug::Log::info("Finish loading obj meshes " + filePath);
+
+		auto end = std::chrono::steady_clock::now();
+		long long microseconds = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+		Core::Engine::Benchmark::addObjParsing(true, dataObj.size(), microseconds);
+
+		float time = (float)microseconds / 1000000.f;
+		Core::Debug::Log::info("Obj " + filePath + " took " + std::to_string(time) + " sec to load");
 	}
 
 	void ResourcesManager::loadObjMulti(const std::string& filePath)
@@ -464,8 +868,6 @@ namespace Resources
 			return;
 		}
 
-		auto start = std::chrono::steady_clock::now();
-
 		std::shared_ptr<LowRenderer::Model> model = models[filePath];
 
 		Core::Debug::Log::info("Start loading obj " + filePath);
@@ -477,6 +879,13 @@ namespace Resources
 		std::vector<std::string> names;
 		std::string dirPath = Utils::getDirectory(filePath);
 
+		// The mapped pre-scan is timed apart, the stream parser throughput only counts the getline parsing
+		auto preScanStart = std::chrono::steady_clock::now();
+		reserveObjData(filePath, vertices, texCoords, normals, indices);
+
+		auto start = std::chrono::steady_clock::now();
+		Core::Engine::Benchmark::addObjPreScan(std::chrono::duration_cast<std::chrono::microseconds>(start - preScanStart).count());
+
 		bool isFirstObject = true;
 		Resources::Mesh mesh;
 
@@ -504,16 +913,8 @@ namespace Resources
 					if (!indices.empty())
 					{
 						// Compute and add the mesh
-						mesh.compute(vertices, texCoords, normals, indices);
-
-						while (lockMeshes.test_and_set());
-
-						// Add the mesh on RM
-						meshes[mesh.name] = std::make_shared<Mesh>(mesh);
-						// Link mesh and material to the model
-						Core::Engine::Graph::addRequest(std::bind(&LowRenderer::Model::addSubModel, model.get(), meshes[mesh.name], loadMaterial(matName)));
-
-						lockMeshes.clear();
+						mesh.compute(vertices, texCoords, normals, indices, vertexLayout);
+						addMesh(model, std::move(mesh), matName, true, false);
 
 						indices.clear();
 					}
@@ -531,7 +932,7 @@ namespace Resources
 			else if (type == "vn")
 				addData(normals, iss);
 			else if (type == "f")
-				addIndices(indices, iss, line);
+				addIndices(indices, iss, line, vertices, texCoords, normals);
 			else if (type == "usemtl")
 				iss >> matName;
 			else if (type == "mtllib")
@@ -540,31 +941,26 @@ namespace Resources
 				iss >> mtlName;
 
 				// Load mtl file
-				ThreadPool::addTask(std::bind(&ResourcesManager::loadMaterialsFromMtlMulti, this, dirPath, mtlName));
+				loadMtlLib(dirPath, mtlName, true, model->getLoadHandle());
 			}
 		}
 
 		if (!indices.empty())
 		{
 			// Compute and add the mesh
-			mesh.compute(vertices, texCoords, normals, indices);
-
-			while (lockMeshes.test_and_set());
-
-			// Add the mesh on RM
-			meshes[mesh.name] = std::make_shared<Mesh>(mesh);
-			// Link mesh and material to the model
-			Core::Engine::Graph::addRequest(std::bind(&LowRenderer::Model::addSubModel, model.get(), meshes[mesh.name], loadMaterial(matName)));
-
-			lockMeshes.clear();
+			mesh.compute(vertices, texCoords, normals, indices, vertexLayout);
+			addMesh(model, std::move(mesh), matName, true, false);
 		}
 		
 		dataObj.close();
 
 		Core::Debug::Log::info("Finish loading obj meshes " + filePath);
 		auto end = std::chrono::steady_clock::now();
+		long long microseconds = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
 
-		float time = (float)(std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()) / 1000.f;
+		Core::Engine::Benchmark::addObjParsing(false, std::filesystem::file_size(PROJECT_DIR + filePath), microseconds);
+
+		float time = (float)microseconds / 1000000.f;
 		Core::Debug::Log::info("Obj " + filePath + " took " + std::to_string(time) + " sec to load");
 
 	}
@@ -582,8 +978,6 @@ namespace Resources
 			return;
 		}
 
-		auto start = std::chrono::steady_clock::now();
-
 		std::shared_ptr<LowRenderer::Model> model = models[filePath];
 
 		Core::Debug::Log::info("Start loading obj " + filePath);
@@ -595,6 +989,13 @@ namespace Resources
 		std::vector<std::string> names;
 		std::string dirPath = Utils::getDirectory(filePath);
 
+		// The mapped pre-scan is timed apart, the stream parser throughput only counts the getline parsing
+		auto preScanStart = std::chrono::steady_clock::now();
+		reserveObjData(filePath, vertices, texCoords, normals, indices);
+
+		auto start = std::chrono::steady_clock::now();
+		Core::Engine::Benchmark::addObjPreScan(std::chrono::duration_cast<std::chrono::microseconds>(start - preScanStart).count());
+
 		bool isFirstObject = true;
 		Resources::Mesh mesh;
 		std::string matName;
@@ -622,21 +1023,8 @@ namespace Resources
 					if (!indices.empty())
 					{
 						// Compute and add the mesh
-						mesh.compute(vertices, texCoords, normals, indices);
-
-						// Add the mesh on RM
-						meshes[mesh.name] = std::make_shared<Mesh>(mesh);
-
-						if (onBenchmark)
-						{
-							model->m_subModels.push_back(LowRenderer::SubModel(meshes[mesh.name], loadMaterial(matName)));
-
-							// Link mesh and material to the model
-							Core::Engine::Graph::addRequest(std::bind(&Mesh::generateVAO, meshes[mesh.name].get()));
-						}
-						else
-							model->addSubModel(meshes[mesh.name], loadMaterial(matName));
-						
+						mesh.compute(vertices, texCoords, normals, indices, vertexLayout);
+						addMesh(model, std::move(mesh), matName, false, onBenchmark);
 					}
 
 					mesh = Mesh();
@@ -652,7 +1040,7 @@ namespace Resources
 			else if (type == "vn")
 				addData(normals, iss);
 			else if (type == "f")
-				addIndices(indices, iss, line);
+				addIndices(indices, iss, line, vertices, texCoords, normals);
 			else if (type == "usemtl")
 				iss >> matName;
 			else if (type == "mtllib")
@@ -661,28 +1049,15 @@ namespace Resources
 				iss >> mtlName;
 
 				// Load mtl file
-				loadMaterialsFromMtlMono(dirPath, mtlName);
+				loadMtlLib(dirPath, mtlName, false, model->getLoadHandle());
 			}
 		}
 
 		if (!indices.empty())
 		{
 			// Compute and generate the mesh
-			mesh.compute(vertices, texCoords, normals, indices);
-
-			// Add the mesh on RM
-			meshes[mesh.name] = std::make_shared<Mesh>(mesh);
-
-			if (onBenchmark)
-			{
-				// Link mesh and material to the model
-				model->m_subModels.push_back(LowRenderer::SubModel(meshes[mesh.name], loadMaterial(matName)));
-
-				// Generate VAO
-				Core::Engine::Graph::addRequest(std::bind(&Mesh::generateVAO, meshes[mesh.name].get()));
-			}
-			else
-				model->addSubModel(meshes[mesh.name], loadMaterial(matName));
+			mesh.compute(vertices, texCoords, normals, indices, vertexLayout);
+			addMesh(model, std::move(mesh), matName, false, onBenchmark);
 		}
 
 		dataObj.close();
@@ -690,177 +1065,85 @@ namespace Resources
 		Core::Debug::Log::info("Finish loading meshes " + filePath);
 
 		auto end = std::chrono::steady_clock::now();
+		long long microseconds = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+		Core::Engine::Benchmark::addObjParsing(false, std::filesystem::file_size(PROJECT_DIR + filePath), microseconds);
 
-		float time = (float)(std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()) / 1000.f;
+		float time = (float)microseconds / 1000000.f;
 		Core::Debug::Log::info("Obj " + filePath + " took " + std::to_string(time) + " sec to load");
 
 		return;
 	}
 
-	void ResourcesManager::loadMaterialsFromMtlMulti(const std::string & dirPath, const std::string & mtlName)
+	void ResourcesManager::loadMaterialsFromMtl(const std::string& dirPath, const std::string& mtlName, bool isMulti, const std::shared_ptr<LoadHandle>& loadHandle)
 	{
 		std::string filePath = dirPath + mtlName;
 
-		// Check if the file exist
-		std::ifstream dataMat((PROJECT_DIR + filePath).c_str());
-		if (!dataMat)
-		{
-			Core::Debug::Log::error("Unable to read the file: " + filePath);
-			dataMat.close();
-			return;
-		}
+		std::vector<Mtl::MaterialData> materialsData;
 
-		std::shared_ptr<Material> mat;
-		std::string line;
-		std::string matName;
-		bool isFirstMat = true;
-
-		Core::Debug::Log::info("Loading materials at " + filePath);
-
-		// Get all mesh materials
-		while (std::getline(dataMat, line))
+		if (useMeshCache && MaterialCache::read(filePath, materialsData))
+			Core::Debug::Log::info("Loading materials at " + filePath + " from their cache");
+		else
 		{
-			std::istringstream iss(line);
-			std::string type;
-			iss >> type;
+			// Check if the file exist
+			std::ifstream dataMat((PROJECT_DIR + filePath).c_str());
+			if (!dataMat)
+			{
+				Core::Debug::Log::error("Unable to read the file: " + filePath);
+				dataMat.close();
+				return;
+			}
 
-			if (type == "#" || type == "" || type == "\n")
-				continue;
+			Core::Debug::Log::info("Loading materials at " + filePath);
 
-			if (type == "newmtl")
+			// Get all mesh materials
+			materialsData = Mtl::parse(dataMat);
+			dataMat.close();
+
+			if (useMeshCache)
 			{
-				if (isFirstMat)
-					isFirstMat = false;
-				else
+				auto writeCache = [filePath, materialsData]()
 				{
-					//setMaterial(mat);
-					mat->isDrawable = true;
-				}
-
-				iss >> matName;
-				mat = loadMaterial(matName);
+					if (!MaterialCache::write(filePath, materialsData))
+						Core::Debug::Log::warning("Unable to write the material cache of " + filePath);
+				};
 
-				continue;
-			}
-			else if (type == "Ns")
-				iss >> mat->shininess;
-			else if (type == "Ka")
-				mat->ambient = getColor(iss);
-			else if (type == "Kd")
-				mat->diffuse = getColor(iss);
-			else if (type == "Ks")
-				mat->specular = getColor(iss);
-			else if (type == "Ke")
-				mat->emissive = getColor(iss);
-			else if (type == "Ni")
-				iss >> mat->opticalDensity;
-			else if (type == "d")
-				iss >> mat->transparency;
-			else if (type == "illum")
-			{
-				iss >> mat->illumination;
-				continue;
+				if (isMulti)
+					ThreadPool::addTask(writeCache, TaskPriority::BACKGROUND);
+				else
+					writeCache();
 			}
-
-			std::string texName;
-			iss >> texName;
-
-			// Load mesh textures
-			if (type == "map_Ka")
-				mat->ambientTex = loadTexture(dirPath + Utils::getFileNameFromPath(texName), true);
-			else if (type == "map_Kd")
-				mat->diffuseTex = loadTexture(dirPath + Utils::getFileNameFromPath(texName), true);
-			else if (type == "map_Ks")
-				mat->specularTex = loadTexture(dirPath + Utils::getFileNameFromPath(texName), true);
-			else if (type == "map_Ke")
-				mat->emissiveTex = loadTexture(dirPath + Utils::getFileNameFromPath(texName), true);
-			else if (type == "map_d")
-				mat->alphaTex = loadTexture(dirPath + Utils::getFileNameFromPath(texName), true);
 		}
 
-		mat->isDrawable = true;
-
-		dataMat.close();
-	}
-
-	void ResourcesManager::loadMaterialsFromMtlMono(const std::string& dirPath, const std::string& mtlName)
-	{
-		std::string filePath = dirPath + mtlName;
-
-		// Check if the file exist
-		std::ifstream dataMat((PROJECT_DIR + filePath).c_str());
-		if (!dataMat)
+		for (const Mtl::MaterialData& data : materialsData)
 		{
-			Core::Debug::Log::error("Unable to read the file: " + filePath);
-			dataMat.close();
-			return;
-		}
+			std::shared_ptr<Material> mat = claimMaterial(data.name);
 
-		std::shared_ptr<Material> mat;
-		std::string line;
-		std::string matName;
-		bool isFirstMat = true;
+			mat->ambient = data.ambient;
+			mat->diffuse = data.diffuse;
+			mat->specular = data.specular;
+			mat->emissive = data.emissive;
 
-		Core::Debug::Log::info("Loading materials at " + filePath);
+			mat->shininess = data.shininess;
+			mat->opticalDensity = data.opticalDensity;
+			mat->transparency = data.transparency;
+			mat->illumination = data.illumination;
 
-		// Get all mesh materials
-		while (std::getline(dataMat, line))
-		{
-			std::istringstream iss(line);
-			std::string type;
-			iss >> type;
-
-			if (type == "#" || type == "" || type == "\n")
-				continue;
-
-			if (type == "newmtl")
+			// Load mesh textures
+			auto loadMap = [&](const std::string& texName, std::shared_ptr<Texture>& texture)
 			{
-				if (isFirstMat)
-					isFirstMat = false;
-				else
-					mat->isDrawable = true;
-
-				iss >> matName;
-				mat = loadMaterial(matName);
+				if (!texName.empty())
+					texture = loadTexture(dirPath + Utils::getFileNameFromPath(texName), isMulti, loadHandle);
+			};
 
-				continue;
-			}
-			else if (type == "Ns")
-				iss >> mat->shininess;
-			else if (type == "Ka")
-				mat->ambient = getColor(iss);
-			else if (type == "Kd")
-				mat->diffuse = getColor(iss);
-			else if (type == "Ks")
-				mat->specular = getColor(iss);
-			else if (type == "Ke")
-				mat->emissive = getColor(iss);
-			else if (type == "Ni")
-				iss >> mat->opticalDensity;
-			else if (type == "d")
-				iss >> mat->transparency;
-			else if (type == "illum")
-				iss >> mat->illumination;
-			
-			std::string texName;
-			iss >> texName;
+			loadMap(data.ambientTex, mat->ambientTex);
+			loadMap(data.diffuseTex, mat->diffuseTex);
+			loadMap(data.specularTex, mat->specularTex);
+			loadMap(data.emissiveTex, mat->emissiveTex);
+			loadMap(data.alphaTex, mat->alphaTex);
 
-			// Load mesh textures
-			if (type == "map_Ka")
-				mat->ambientTex  = loadTexture(dirPath + Utils::getFileNameFromPath(texName), false);
-			else if (type == "map_Kd")
-				mat->diffuseTex  = loadTexture(dirPath + Utils::getFileNameFromPath(texName), false);
-			else if (type == "map_Ks")
-				mat->specularTex = loadTexture(dirPath + Utils::getFileNameFromPath(texName), false);
-			else if (type == "map_Ke")
-				mat->emissiveTex = loadTexture(dirPath + Utils::getFileNameFromPath(texName), false);
-			else if (type == "map_d")
-				mat->alphaTex    = loadTexture(dirPath + Utils::getFileNameFromPath(texName), false);
+			publishMaterial(mat);
 		}
-
-		mat->isDrawable = true;
-
-		dataMat.close();
 	}
 
 	// Return a mesh from its name (Thread safe)
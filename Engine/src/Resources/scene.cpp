@@ -4,6 +4,8 @@
 #include <fstream>
 #include <istream>
 #include <thread>
+#include <limits>
+#include <algorithm>
 
 #include "imgui.h"
 
@@ -46,6 +48,7 @@ namespace Resources
 	void Scene::clear()
 	{
 		LowRenderer::RenderManager::clearComponents<LowRenderer::SpriteRenderer>();
+		LowRenderer::RenderManager::clearComponents<Resources::Text>();
 		LowRenderer::RenderManager::clearComponents<LowRenderer::ColliderRenderer>();
 		LowRenderer::RenderManager::clearComponents<LowRenderer::ModelRenderer>();
 		LowRenderer::RenderManager::clearComponents<LowRenderer::Camera>();
@@ -59,6 +62,103 @@ namespace Resources
 		Resources::ResourcesManager::clearResources();
 	}
 
+	// Scene file block of a game object, read before it is parsed to order the loadings
+	struct GameObjectEntry
+	{
+		std::string name;
+		std::string block;
+		std::string parentName;
+
+		Core::Maths::vec3 position;
+		bool hasPosition = false;
+		bool isCamera = false;
+
+		TaskPriority priority = TaskPriority::NORMAL;
+		bool hasPriority = false;
+		float distance = 0.f;
+	};
+
+	bool parsePriority(const std::string& name, TaskPriority& priority)
+	{
+		if (name == "CRITICAL")
+			priority = TaskPriority::CRITICAL;
+		else if (name == "NORMAL")
+			priority = TaskPriority::NORMAL;
+		else if (name == "BACKGROUND")
+			priority = TaskPriority::BACKGROUND;
+		else
+			return false;
+
+		return true;
+	}
+
+	void readGameObjectEntry(std::istream& scnStream, GameObjectEntry& entry)
+	{
+		std::string line;
+
+		while (std::getline(scnStream, line))
+		{
+			entry.block += line + '\n';
+
+			std::istringstream iss(line);
+			std::string type, comp;
+			iss >> type;
+
+			if (type == "endGO")
+				break;
+
+			if (type == "PRIORITY")
+			{
+				std::string priorityName;
+				iss >> priorityName;
+
+				entry.hasPriority = parsePriority(priorityName, entry.priority);
+				if (!entry.hasPriority)
+					Core::Debug::Log::warning("Unknown loading priority " + priorityName + " of " + entry.name);
+			}
+
+			if (type != "COMP")
+				continue;
+
+			iss >> comp;
+
+			if (comp == "CAMERA")
+				entry.isCamera = true;
+			else if (comp == "TRANSFORM")
+			{
+				iss >> entry.position.x >> entry.position.y >> entry.position.z;
+
+				// Rotation and scale, then the parent
+				float value;
+				for (int i = 0; i < 6; i++)
+					iss >> value;
+
+				iss >> entry.parentName;
+				entry.hasPosition = !iss.fail();
+			}
+		}
+	}
+
+	// Sum of the positions along the parents (their rotation and scale are ignored, close enough to sort)
+	Core::Maths::vec3 getWorldPosition(const std::vector<GameObjectEntry>& entries, const std::unordered_map<std::string, size_t>& indices, size_t index)
+	{
+		Core::Maths::vec3 position;
+
+		for (size_t depth = 0; depth < entries.size(); depth++)
+		{
+			const GameObjectEntry& entry = entries[index];
+			position = position + entry.position;
+
+			auto parent = indices.find(entry.parentName);
+			if (parent == indices.end())
+				break;
+
+			index = parent->second;
+		}
+
+		return position;
+	}
+
 	void Scene::load(const std::string& _filePath, bool isMultiThreaded)
 	{
 		Core::Engine::Benchmark::startTimer();
@@ -75,6 +175,10 @@ namespace Resources
 
 		curGoName = "";
 
+		// Read every object first, their loadings are requested by distance to the camera
+		std::vector<GameObjectEntry> entries;
+		std::unordered_map<std::string, size_t> indices;
+
 		while (std::getline(scnStream, line))
 		{
 			if (line == "") continue;
@@ -84,25 +188,99 @@ namespace Resources
 
 			if (type == "GO")
 			{
-				std::string goName, parentName;
-				iss >> goName;
+				GameObjectEntry entry;
+				iss >> entry.name;
 
-				Engine::GameObject& gameObject = instantiate(goName);
-				gameObject.parse(scnStream, parentName, isMultiThreaded);
+				readGameObjectEntry(scnStream, entry);
+
+				indices[entry.name] = entries.size();
+				entries.push_back(std::move(entry));
+			}
+		}
 
-				if (parentName == "" || parentName == "none")
-					continue;
+		scnStream.close();
 
-				parents.push_back(parentName);
-				parents.push_back(goName);
+		Core::Maths::vec3 cameraPosition;
+		for (size_t i = 0; i < entries.size(); i++)
+		{
+			if (entries[i].isCamera)
+			{
+				cameraPosition = getWorldPosition(entries, indices, i);
+				break;
 			}
-				
+		}
+
+		for (size_t i = 0; i < entries.size(); i++)
+		{
+			GameObjectEntry& entry = entries[i];
+
+			// From a recipe, no position to sort it with: after the others of its lane
+			if (!entry.hasPosition)
+			{
+				entry.distance = std::numeric_limits<float>::max();
+				continue;
+			}
+
+			entry.distance = (getWorldPosition(entries, indices, i) - cameraPosition).magnitude();
+
+			if (!entry.hasPriority)
+				entry.priority = entry.distance <= SCENE_CRITICAL_DISTANCE ? TaskPriority::CRITICAL : TaskPriority::NORMAL;
+		}
+
+		std::stable_sort(entries.begin(), entries.end(), [](const GameObjectEntry& lhs, const GameObjectEntry& rhs)
+		{
+			if (lhs.priority != rhs.priority)
+				return lhs.priority < rhs.priority;
+
+			return lhs.distance < rhs.distance;
+		});
+
+		// Interactive once the critical objects and the resources they requested are loaded, the scene handle also waits for them
+		std::shared_ptr<LoadHandle> interactiveHandle = nullptr;
+		if (loadHandle)
+		{
+			interactiveHandle = std::make_shared<LoadHandle>(loadHandle, [](float) { Core::Engine::Benchmark::setInteractive(); });
+			Resources::ResourcesManager::setThreadLoadHandle(interactiveHandle);
+		}
+
+		for (const GameObjectEntry& entry : entries)
+		{
+			if (interactiveHandle && entry.priority != TaskPriority::CRITICAL)
+			{
+				Resources::ResourcesManager::setThreadLoadHandle(nullptr);
+				interactiveHandle->endJob(LoadHandle::JobType::LOADING);
+				interactiveHandle = nullptr;
+			}
+
+			// The loadings requested by the object, and the tasks they add, run on its lane
+			ThreadPool::PriorityScope priorityScope(entry.priority);
+
+			std::istringstream goStream(entry.block);
+			std::string parentName;
+
+			Engine::GameObject& gameObject = instantiate(entry.name);
+			gameObject.parse(goStream, parentName, isMultiThreaded);
+
+			if (parentName == "" || parentName == "none")
+				continue;
+
+			parents.push_back(parentName);
+			parents.push_back(entry.name);
+		}
+
+		// Only critical objects (or none)
+		if (interactiveHandle)
+		{
+			Resources::ResourcesManager::setThreadLoadHandle(nullptr);
+			interactiveHandle->endJob(LoadHandle::JobType::LOADING);
 		}
 
 		for (size_t i = 0; i < parents.size(); i += 2)
 			setGameObjectParent(parents[i], parents[i + 1]);
 
-		scnStream.close();
+		// Every resource request is sent, the handle now only waits for them
+		if (loadHandle)
+			loadHandle->endJob(LoadHandle::JobType::LOADING);
 	}
 
 	void Scene::save(const std::string& path)
@@ -236,6 +236,11 @@ namespace Resources
         #pragma endregion
     }
 
+    bool ShaderProgram::hasUniform(const std::string& target) const
+    {
+        return uniforms.find(target) != uniforms.end();
+    }
+
     void ShaderProgram::bind() const
     {
         glUseProgram(programID);
@@ -1,10 +1,18 @@
 #include "texture.hpp"
 
 #include <imgui.h>
+#include <cstring>
 #include <filesystem>
+#include <algorithm>
 
 #include "stb_image.h"
 #include "define.hpp"
+#include "texture_cache.hpp"
+#include "texture_streamer.hpp"
+#include "resources_manager.hpp"
+#include "mapped_file.hpp"
+#include "utils.hpp"
+#include "hash.hpp"
 
 #include "debug.hpp"
 #include "graph.hpp"
@@ -17,25 +25,191 @@ namespace Resources
 	 std::shared_ptr<Texture> Texture::defaultEmissive = nullptr;
 	 std::shared_ptr<Texture> Texture::defaultSpecular = nullptr;
 
+	 std::atomic<size_t> Texture::totalResidentSize{ 0 };
+
+	// GL formats of the texture channels, HDR images keep half floats
+	static GLenum getInternalFormat(int channels, bool isHDR)
+	{
+		switch (channels)
+		{
+		case 1:  return isHDR ? GL_R16F : GL_R8;
+		case 2:  return isHDR ? GL_RG16F : GL_RG8;
+		case 3:  return isHDR ? GL_RGB16F : GL_RGB8;
+		default: return isHDR ? GL_RGBA16F : GL_RGBA8;
+		}
+	}
+
+	static GLenum getFormat(int channels)
+	{
+		switch (channels)
+		{
+		case 1:  return GL_RED;
+		case 2:  return GL_RG;
+		case 3:  return GL_RGB;
+		default: return GL_RGBA;
+		}
+	}
+
 	bool Texture::load(const std::string& filePath)
 	{
 		stbi_set_flip_vertically_on_load_thread(true);
 
-		int channel = 0;
-		// Get the color buffer by using stbi
-		colorBuffer = stbi_loadf(filePath.c_str(), &width, &height, &channel, STBI_rgb_alpha);
+		// Only HDR images are read as floats, the others keep 8 bits and their channels count
+		isHDR = stbi_is_hdr(filePath.c_str());
+
+		if (isHDR)
+		{
+			pixelType = GL_FLOAT;
+			pixels = stbi_loadf(filePath.c_str(), &width, &height, &channels, 0);
+		}
+		else
+		{
+			pixelType = GL_UNSIGNED_BYTE;
+			pixels = stbi_load(filePath.c_str(), &width, &height, &channels, 0);
+		}
 
-		return colorBuffer;
+		return pixels;
 	}
 
-	void Texture::create(const std::string& filePath, bool isMulti)
+	static GLenum getCompressedFormat(BC::Format format)
 	{
-		if (load(filePath))
+		switch (format)
+		{
+		case BC::Format::BC1: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+		case BC::Format::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+		case BC::Format::BC4: return GL_COMPRESSED_RED_RGTC1;
+		default:              return GL_COMPRESSED_RG_RGTC2;
+		}
+	}
+
+	bool Texture::loadCompressed(const std::string& filePath, bool useCache, uint64_t contentHash)
+	{
+		if (!load(filePath))
+			return false;
+
+		// No block format for the float images, their mips are uploaded uncompressed
+		if (!useCache || isHDR)
+		{
+			if (isHDR)
+				Mipmap::generate((const float*)pixels, width, height, channels, mips);
+			else
+				Mipmap::generate((const unsigned char*)pixels, width, height, channels, mips);
+
+			return true;
+		}
+
+		// First load, compress the image and its mips for the next ones
+		TextureCache::compress((const unsigned char*)pixels, width, height, channels, compressed);
+		compressed.contentHash = contentHash;
+
+		if (!TextureCache::write(filePath, compressed))
+			Core::Debug::Log::warning("Unable to write the texture cache of " + filePath);
+
+		stbi_image_free(pixels);
+		pixels = nullptr;
+
+		return true;
+	}
+
+	bool Texture::findSameContent(const std::string& filePath, uint64_t contentHash, size_t fileSize)
+	{
+		std::shared_ptr<Texture> texture = ResourcesManager::shareTextureContent(contentHash, shared_from_this());
+		if (!texture)
+			return false;
+
+		Core::Engine::Benchmark::addTextureDeduplicated((long long)fileSize);
+
+		m_filePath = filePath;
+		aliasTo(texture);
+
+		return true;
+	}
+
+	void Texture::aliasTo(const std::shared_ptr<Texture>& texture)
+	{
+		source = texture;
+
+		while (source->lockAliases.test_and_set());
+
+		// Released with the source
+		if (!source->isLoadEnded)
+		{
+			source->aliases.push_back(weak_from_this());
+			source->lockAliases.clear();
+			return;
+		}
+
+		source->lockAliases.clear();
+
+		isDrawable.store(source->isDrawable.load(std::memory_order_acquire), std::memory_order_release);
+		loadWaiters.release();
+	}
+
+	void Texture::releaseAliases()
+	{
+		while (lockAliases.test_and_set());
+
+		isLoadEnded = true;
+
+		std::vector<std::weak_ptr<Texture>> released = std::move(aliases);
+		aliases.clear();
+
+		lockAliases.clear();
+
+		for (const std::weak_ptr<Texture>& weakAlias : released)
+		{
+			if (std::shared_ptr<Texture> alias = weakAlias.lock())
+			{
+				alias->isDrawable.store(isDrawable.load(std::memory_order_acquire), std::memory_order_release);
+				alias->loadWaiters.release();
+			}
+		}
+	}
+
+	void Texture::create(const std::string& filePath, bool isMulti, bool useCache, bool isStreamed)
+	{
+		// Read the blocks straight from the cache, no decoding. The cache keeps the hash of the image, only hashed on a miss
+		bool isCached = useCache && TextureCache::read(filePath, compressed);
+
+		uint64_t contentHash = compressed.contentHash;
+		size_t fileSize = isCached ? compressed.file->size() : 0;
+
+		if (!isCached)
+		{
+			Utils::MappedFile file(filePath);
+			if (file.isOpen())
+			{
+				contentHash = Utils::hashBytes(file.data(), file.size());
+				fileSize = file.size();
+			}
+		}
+
+		// Same bytes as a texture of another path, nothing to decode nor upload
+		if (contentHash != 0 && findSameContent(filePath, contentHash, fileSize))
+		{
+			compressed = TextureCache::CompressedImage();
+			return;
+		}
+
+		if (isCached || loadCompressed(filePath, useCache, contentHash))
 		{
 			m_filePath = filePath;
 
-			if (isMulti)
-				Core::Engine::Graph::addRequest(std::bind(&Texture::generate, this));
+			if (!compressed.levels.empty())
+				levelsCount = (GLint)compressed.levels.size();
+			else
+				levelsCount = std::max((GLint)mips.levels.size(), 1);
+
+			if (isStreamed)
+			{
+				streamedLevels = levelsCount;
+				TextureStreamer::add(shared_from_this());
+			}
+			else if (isMulti)
+			{
+				stageLevels();
+				Core::Engine::Graph::addRequest([this]() { generate(); });
+			}
 			else
 				generate();
 
@@ -47,6 +221,10 @@ namespace Resources
 		std::string errorStr = error + ' ';
 
 		Core::Debug::Log::error(error + filePath);
+
+		// Nothing to wait for anymore
+		loadWaiters.release();
+		releaseAliases();
 	}
 
 	void Texture::set(const std::string& filePath, int _width, int _height, float* _colorBuffer)
@@ -54,36 +232,67 @@ namespace Resources
 		if (!_colorBuffer)
 		{
 			Core::Debug::Log::error("Texture " + m_filePath + " buffer is not valid");
+			loadWaiters.release();
 			return;
 		}
 
+		// Float RGBA colors, stored in 8 bits
 		width = _width;
 		height = _height;
-		colorBuffer = _colorBuffer;
+		channels = 4;
+		isHDR = false;
+		pixelType = GL_FLOAT;
+		pixels = _colorBuffer;
 		m_filePath = filePath;
 
 		generateID();
+
+		// The buffer belongs to the caller
+		pixels = nullptr;
 	}
 
 	Texture::~Texture()
 	{
+		// Deleted before its upload
+		TextureUploader::release(upload);
+
 		if (textureID)
+		{
 			glDeleteTextures(1, &textureID);
+			totalResidentSize.fetch_sub(residentSize);
+			Core::Engine::Benchmark::addTexturesMemory(-(long long)residentSize);
+		}
 	}
 
 	void Texture::generate()
 	{
-		if (!colorBuffer)
+		if (!pixels && compressed.levels.empty())
 		{
 			Core::Debug::Log::error("Texture " + m_filePath + " buffer is not valid");
+			loadWaiters.release();
+			releaseAliases();
 			return;
 		}
 
 		generateID();
-		stbi_image_free(colorBuffer);
+		freeLevels();
 	}
 
-	void Texture::generateID()
+	void Texture::freeLevels()
+	{
+		if (pixels)
+		{
+			stbi_image_free(pixels);
+			pixels = nullptr;
+		}
+
+		// Free the levels (or unmap their cache) once on the GPU
+		compressed = TextureCache::CompressedImage();
+		mips = Mipmap::Chain();
+		streamedLevels = 0;
+	}
+
+	void Texture::createID()
 	{
 		// Generate the texture ID
 		glGenTextures(1, &textureID);
@@ -92,27 +301,185 @@ namespace Resources
 		// Set the texture parameters
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_FLOAT, colorBuffer);
+		if (!compressed.levels.empty())
+		{
+			channels = compressed.channels;
+			width = compressed.levels[0].width;
+			height = compressed.levels[0].height;
+		}
+
+		// Grey images are read as grey (with alpha in the second channel)
+		if (channels <= 2)
+		{
+			GLint swizzle[4] = { GL_RED, GL_RED, GL_RED, channels == 2 ? GL_GREEN : GL_ONE };
+			glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+		}
+	}
+
+	size_t Texture::getLevelResidentSize(GLint level) const
+	{
+		if (!compressed.levels.empty())
+			return compressed.levels[level].size;
+
+		int levelWidth = mips.levels.empty() ? width : mips.levels[level].width;
+		int levelHeight = mips.levels.empty() ? height : mips.levels[level].height;
+
+		return (size_t)levelWidth * levelHeight * channels * (isHDR ? sizeof(unsigned short) : sizeof(unsigned char));
+	}
+
+	const void* Texture::getLevelPixels(GLint level) const
+	{
+		if (!compressed.levels.empty())
+			return compressed.levels[level].data;
+
+		// Mips prepared by the loading thread (none for the buffers given to set)
+		return mips.levels.empty() ? pixels : mips.levels[level].pixels;
+	}
+
+	size_t Texture::getLevelSize(GLint level) const
+	{
+		if (!compressed.levels.empty())
+			return compressed.levels[level].size;
+
+		return mips.levels.empty() ? (size_t)width * height * channels * (pixelType == GL_FLOAT ? sizeof(float) : sizeof(unsigned char)) : mips.levels[level].size;
+	}
+
+	void Texture::stageLevels()
+	{
+		uploadOffsets.resize(levelsCount);
+
+		size_t size = 0;
+		for (GLint i = 0; i < levelsCount; i++)
+		{
+			uploadOffsets[i] = size;
+			size += (getLevelSize(i) + 3) & ~(size_t)3;
+		}
+
+		if (!TextureUploader::reserve(size, upload))
+			return;
+
+		for (GLint i = 0; i < levelsCount; i++)
+			memcpy(upload.data + uploadOffsets[i], getLevelPixels(i), getLevelSize(i));
+	}
+
+	void Texture::uploadLevel(GLint level)
+	{
+		// Offset in the bound upload ring, or pointer to the client memory
+		const void* source = upload.isValid() ? (const void*)(upload.offset + uploadOffsets[level]) : getLevelPixels(level);
+
+		if (!compressed.levels.empty())
+		{
+			// Block compressed levels, uploaded as they are
+			const TextureCache::Level& cur = compressed.levels[level];
+			GLenum format = getCompressedFormat(compressed.format);
+
+			if (hasStorage)
+				glCompressedTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, cur.width, cur.height, format, (GLsizei)cur.size, source);
+			else
+				glCompressedTexImage2D(GL_TEXTURE_2D, level, format, cur.width, cur.height, 0, (GLsizei)cur.size, source);
+		}
+		else
+		{
+			int levelWidth = mips.levels.empty() ? width : mips.levels[level].width;
+			int levelHeight = mips.levels.empty() ? height : mips.levels[level].height;
+
+			// Rows of R, RG and RGB pixels are not 4 bytes aligned
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+			if (hasStorage)
+				glTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, levelWidth, levelHeight, getFormat(channels), pixelType, source);
+			else
+				glTexImage2D(GL_TEXTURE_2D, level, getInternalFormat(channels, isHDR), levelWidth, levelHeight, 0, getFormat(channels), pixelType, source);
+
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		}
 
-		// Generate its mipmap
-		//glGenerateMipmap(GL_TEXTURE_2D);
+		size_t levelSize = getLevelResidentSize(level);
+
+		residentSize += levelSize;
+		totalResidentSize.fetch_add(levelSize);
+		Core::Engine::Benchmark::addTexturesMemory((long long)levelSize);
+	}
 
+	void Texture::setResidentLevels(GLint baseLevel)
+	{
+		// Sampling is limited to the uploaded levels
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, baseLevel);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelsCount - 1);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, levelsCount - baseLevel > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+	}
+
+	void Texture::setDrawable()
+	{
 		isDrawable = true;
 
 		Core::Engine::Benchmark::addTexturesCount(1);
+
+		loadWaiters.release();
+		releaseAliases();
+	}
+
+	void Texture::generateID()
+	{
+		createID();
+
+		GLenum internalFormat = compressed.levels.empty() ? getInternalFormat(channels, isHDR) : getCompressedFormat(compressed.format);
+		glTexStorage2D(GL_TEXTURE_2D, levelsCount, internalFormat, width, height);
+		hasStorage = true;
+
+		// The GPU copies the staged levels from the ring, the frame does not wait for them
+		if (upload.isValid())
+			TextureUploader::bind();
+
+		for (GLint i = 0; i < levelsCount; i++)
+			uploadLevel(i);
+
+		if (upload.isValid())
+			TextureUploader::submit(upload);
+
+		setResidentLevels(0);
+		setDrawable();
+	}
+
+	void Texture::streamNextLevel()
+	{
+		if (!textureID)
+			createID();
+		else
+			glBindTexture(GL_TEXTURE_2D, textureID);
+
+		streamedLevels--;
+
+		uploadLevel(streamedLevels);
+		setResidentLevels(streamedLevels);
+
+		if (!isDrawable)
+			setDrawable();
+
+		if (streamedLevels == 0)
+			freeLevels();
+	}
+
+	size_t Texture::getTotalResidentSize()
+	{
+		return totalResidentSize.load();
+	}
+
+	size_t Texture::getResidentSize() const
+	{
+		return residentSize;
 	}
 
 	GLuint Texture::getID() const
 	{
-		return textureID;
+		return source ? source->getID() : textureID;
 	}
 
 	void Texture::bind(int textureIndex) const
 	{
 		glActiveTexture(GL_TEXTURE0 + textureIndex);
-		glBindTexture(GL_TEXTURE_2D, textureID);
+		glBindTexture(GL_TEXTURE_2D, getID());
 	}
 }
\ No newline at end of file
@@ -0,0 +1,174 @@
+#include "texture_atlas.hpp"
+
+#include <cstring>
+#include <algorithm>
+
+#include "imstb_rectpack.h"
+#include "stb_image.h"
+
+#include "benchmark.hpp"
+#include "graph.hpp"
+#include "debug.hpp"
+
+namespace Resources
+{
+	struct TextureAtlas::Page
+	{
+		GLuint ID = 0;
+
+		// Kept to pack the next images, the regions are written by their loading threads
+		std::vector<unsigned char> pixels;
+
+		stbrp_context context;
+		std::vector<stbrp_node> nodes;
+
+		Page()
+			: pixels((size_t)ATLAS_PAGE_SIZE * ATLAS_PAGE_SIZE * 4, 0), nodes(ATLAS_PAGE_SIZE)
+		{
+			stbrp_init_target(&context, ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE, nodes.data(), (int)nodes.size());
+		}
+	};
+
+	TextureAtlas::~TextureAtlas()
+	{
+		for (const std::unique_ptr<Page>& page : pages)
+		{
+			if (page->ID)
+			{
+				glDeleteTextures(1, &page->ID);
+				Core::Engine::Benchmark::addTexturesMemory(-(long long)page->pixels.size());
+			}
+		}
+	}
+
+	bool TextureAtlas::fits(const std::string& filePath)
+	{
+		int width = 0, height = 0, channels = 0;
+		if (!stbi_info(filePath.c_str(), &width, &height, &channels) || stbi_is_hdr(filePath.c_str()))
+			return false;
+
+		return width <= ATLAS_MAX_IMAGE_SIZE && height <= ATLAS_MAX_IMAGE_SIZE;
+	}
+
+	void TextureAtlas::add(const std::shared_ptr<AtlasRegion>& region, const std::string& filePath, bool isOnRequest)
+	{
+		TextureAtlas* TA = instance();
+
+		stbi_set_flip_vertically_on_load_thread(true);
+
+		int width = 0, height = 0, channels = 0;
+		unsigned char* pixels = stbi_load(filePath.c_str(), &width, &height, &channels, 4);
+		if (!pixels)
+		{
+			Core::Debug::Log::error(std::string(stbi_failure_reason()) + " " + filePath);
+			region->loadWaiters.release();
+			return;
+		}
+
+		// Place the image in the first page with room, or in a new one
+		stbrp_rect rect = {};
+		rect.w = (stbrp_coord)(width + 2 * ATLAS_PADDING);
+		rect.h = (stbrp_coord)(height + 2 * ATLAS_PADDING);
+
+		while (TA->lockPages.test_and_set());
+
+		size_t pageIndex = 0;
+		for (; pageIndex < TA->pages.size(); pageIndex++)
+		{
+			if (stbrp_pack_rects(&TA->pages[pageIndex]->context, &rect, 1))
+				break;
+		}
+
+		if (pageIndex == TA->pages.size())
+		{
+			TA->pages.push_back(std::make_unique<Page>());
+			stbrp_pack_rects(&TA->pages.back()->context, &rect, 1);
+		}
+
+		Page* page = TA->pages[pageIndex].get();
+
+		TA->lockPages.clear();
+
+		// Copy the image in its place, the border pixels are repeated in the padding
+		for (int y = 0; y < rect.h; y++)
+		{
+			const unsigned char* srcRow = pixels + (size_t)std::clamp(y - ATLAS_PADDING, 0, height - 1) * width * 4;
+			unsigned char* dstRow = page->pixels.data() + ((size_t)(rect.y + y) * ATLAS_PAGE_SIZE + rect.x) * 4;
+
+			for (int x = 0; x < ATLAS_PADDING; x++)
+			{
+				memcpy(dstRow + x * 4, srcRow, 4);
+				memcpy(dstRow + (ATLAS_PADDING + width + x) * 4, srcRow + (width - 1) * 4, 4);
+			}
+
+			memcpy(dstRow + ATLAS_PADDING * 4, srcRow, (size_t)width * 4);
+		}
+
+		stbi_image_free(pixels);
+
+		region->page = (int)pageIndex;
+		region->uvRect = Core::Maths::vec4((float)(rect.x + ATLAS_PADDING) / ATLAS_PAGE_SIZE, (float)(rect.y + ATLAS_PADDING) / ATLAS_PAGE_SIZE,
+			(float)width / ATLAS_PAGE_SIZE, (float)height / ATLAS_PAGE_SIZE);
+
+		if (isOnRequest)
+			Core::Engine::Graph::addRequest([TA, region, page, rect]() { TA->uploadRegion(region, page, rect.x, rect.y, rect.w, rect.h); });
+		else
+			TA->uploadRegion(region, page, rect.x, rect.y, rect.w, rect.h);
+	}
+
+	void TextureAtlas::uploadRegion(std::shared_ptr<AtlasRegion> region, Page* page, int x, int y, int width, int height)
+	{
+		if (!page->ID)
+		{
+			glGenTextures(1, &page->ID);
+			glBindTexture(GL_TEXTURE_2D, page->ID);
+
+			// No mips, they would mix the images
+			glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE);
+
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+			Core::Engine::Benchmark::addTexturesCount(1);
+			Core::Engine::Benchmark::addTexturesMemory((long long)page->pixels.size());
+		}
+		else
+			glBindTexture(GL_TEXTURE_2D, page->ID);
+
+		// Only the rectangle of the region, read in the page rows
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, ATLAS_PAGE_SIZE);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, page->pixels.data() + ((size_t)y * ATLAS_PAGE_SIZE + x) * 4);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+		region->isDrawable = true;
+		region->loadWaiters.release();
+	}
+
+	GLuint TextureAtlas::getPageID(int page)
+	{
+		TextureAtlas* TA = instance();
+
+		while (TA->lockPages.test_and_set());
+
+		GLuint ID = page >= 0 && page < (int)TA->pages.size() ? TA->pages[page]->ID : 0;
+
+		TA->lockPages.clear();
+
+		return ID;
+	}
+
+	size_t TextureAtlas::getPagesCount()
+	{
+		TextureAtlas* TA = instance();
+
+		while (TA->lockPages.test_and_set());
+
+		size_t count = TA->pages.size();
+
+		TA->lockPages.clear();
+
+		return count;
+	}
+}
@@ -0,0 +1,179 @@
+#include "texture_cache.hpp"
+
+#include <cstring>
+#include <cstdint>
+
+#include "binary_io.hpp"
+#include "mipmap.hpp"
+#include "hash.hpp"
+
+namespace Resources::TextureCache
+{
+	static const char magic[4] = { 'R', 'T', 'E', 'X' };
+
+	size_t CompressedImage::getSize() const
+	{
+		size_t size = 0;
+		for (const Level& level : levels)
+			size += level.size;
+
+		return size;
+	}
+
+	std::string getCachePath(const std::string& imagePath)
+	{
+		// The extension is kept so images with the same name do not share a cache
+		return imagePath + ".tex";
+	}
+
+	bool readLevels(Utils::BinaryReader& reader, BC::Format format, std::vector<Level>& levels)
+	{
+		// Bounded by the file, a corrupt count never makes a huge resize
+		levels.resize(reader.count(2 * sizeof(uint32_t)));
+		if (!reader.valid || levels.empty())
+			return false;
+
+		for (size_t i = 0; i < levels.size(); i++)
+		{
+			Level& level = levels[i];
+			uint32_t width = reader.value<uint32_t>();
+			uint32_t height = reader.value<uint32_t>();
+
+			// The level 0 gives the chain, each next level is half the previous one
+			if (i == 0)
+			{
+				if (width < 1 || height < 1 || width > TEXTURE_CACHE_MAX_SIZE || height > TEXTURE_CACHE_MAX_SIZE
+					|| levels.size() > (size_t)Mipmap::getLevelsCount((int)width, (int)height))
+					return false;
+			}
+			else if ((int)width != Mipmap::getNextSize(levels[i - 1].width) || (int)height != Mipmap::getNextSize(levels[i - 1].height))
+				return false;
+
+			level.width = (int)width;
+			level.height = (int)height;
+			level.size = BC::getLevelSize(format, level.width, level.height);
+			level.data = (const unsigned char*)reader.bytes(level.size);
+		}
+
+		return reader.valid;
+	}
+
+	bool read(const std::string& imagePath, CompressedImage& image)
+	{
+		// Without its image the cache is a baked asset, used whatever its key
+		uint64_t sourceSize = 0;
+		int64_t sourceTime = 0;
+		bool hasSource = Utils::getSourceKey(imagePath, sourceSize, sourceTime);
+
+		std::shared_ptr<Utils::MappedFile> file = std::make_shared<Utils::MappedFile>(getCachePath(imagePath));
+		if (!file->isOpen())
+			return false;
+
+		Utils::BinaryReader reader(file->data(), file->end());
+
+		// Check the header and the key, the path is not part of it: the engine and the converter use different ones
+		const char* fileMagic = reader.bytes(sizeof(magic));
+		if (!fileMagic || memcmp(fileMagic, magic, sizeof(magic)) != 0
+			|| reader.value<uint32_t>() != TEXTURE_CACHE_VERSION)
+			return false;
+
+		uint64_t cachedSize = reader.value<uint64_t>();
+		int64_t cachedTime = reader.value<int64_t>();
+		if (hasSource && (cachedSize != sourceSize || cachedTime != sourceTime))
+			return false;
+
+		image.contentHash = reader.value<uint64_t>();
+
+		image.format = (BC::Format)reader.value<uint32_t>();
+		image.channels = (int)reader.value<uint32_t>();
+		if (image.format > BC::Format::BC5 || image.channels < 1 || image.channels > 4)
+			return false;
+
+		if (!readLevels(reader, image.format, image.levels))
+			return false;
+
+		image.file = file;
+		image.data.clear();
+
+		return true;
+	}
+
+	bool write(const std::string& imagePath, const CompressedImage& image)
+	{
+		uint64_t sourceSize;
+		int64_t sourceTime;
+		if (!Utils::getSourceKey(imagePath, sourceSize, sourceTime))
+			return false;
+
+		uint64_t contentHash = image.contentHash;
+		if (contentHash == 0)
+		{
+			Utils::MappedFile source(imagePath);
+			if (!source.isOpen())
+				return false;
+
+			contentHash = Utils::hashBytes(source.data(), source.size());
+		}
+
+		return Utils::writeAtomically(getCachePath(imagePath), [&](Utils::BinaryWriter& writer)
+		{
+			writer.bytes(magic, sizeof(magic));
+			writer.value((uint32_t)TEXTURE_CACHE_VERSION);
+			writer.value(sourceSize);
+			writer.value(sourceTime);
+			writer.value(contentHash);
+
+			writer.value((uint32_t)image.format);
+			writer.value((uint32_t)image.channels);
+
+			writer.value((uint32_t)image.levels.size());
+			for (const Level& level : image.levels)
+			{
+				writer.value((uint32_t)level.width);
+				writer.value((uint32_t)level.height);
+				writer.bytes(level.data, level.size);
+			}
+
+			return true;
+		});
+	}
+
+	void compress(const unsigned char* pixels, int width, int height, int channels, CompressedImage& image)
+	{
+		compress(pixels, width, height, channels, BC::getFormat(pixels, width, height, channels), image);
+	}
+
+	void compress(const unsigned char* pixels, int width, int height, int channels, BC::Format format, CompressedImage& image)
+	{
+		image.format = format;
+		image.channels = channels;
+		image.file = nullptr;
+
+		Mipmap::Chain mips;
+		Mipmap::generate(pixels, width, height, channels, mips);
+
+		// Offsets of the levels in one buffer
+		image.levels.resize(mips.levels.size());
+
+		size_t dataSize = 0;
+		for (size_t i = 0; i < mips.levels.size(); i++)
+		{
+			image.levels[i].width = mips.levels[i].width;
+			image.levels[i].height = mips.levels[i].height;
+			image.levels[i].size = BC::getLevelSize(image.format, mips.levels[i].width, mips.levels[i].height);
+			dataSize += image.levels[i].size;
+		}
+
+		image.data.resize(dataSize);
+
+		unsigned char* output = image.data.data();
+		for (size_t i = 0; i < mips.levels.size(); i++)
+		{
+			Level& level = image.levels[i];
+
+			BC::compress(image.format, (const unsigned char*)mips.levels[i].pixels, level.width, level.height, channels, output);
+			level.data = output;
+			output += level.size;
+		}
+	}
+}
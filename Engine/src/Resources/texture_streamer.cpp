@@ -0,0 +1,114 @@
+#include "texture_streamer.hpp"
+
+#include <algorithm>
+
+namespace Resources
+{
+	bool TextureStreamer::isBigger(const Entry& lhs, const Entry& rhs)
+	{
+		return lhs.nextLevelSize > rhs.nextLevelSize;
+	}
+
+	void TextureStreamer::push(const std::shared_ptr<Texture>& texture)
+	{
+		queue.push_back({ texture->getLevelResidentSize(texture->streamedLevels - 1), texture });
+		std::push_heap(queue.begin(), queue.end(), isBigger);
+	}
+
+	void TextureStreamer::add(const std::shared_ptr<Texture>& texture)
+	{
+		TextureStreamer* TS = instance();
+
+		while (TS->lockAdded.test_and_set());
+
+		TS->added.push_back(texture);
+
+		TS->lockAdded.clear();
+	}
+
+	void TextureStreamer::update()
+	{
+		TextureStreamer* TS = instance();
+
+		while (TS->lockAdded.test_and_set());
+
+		std::vector<std::shared_ptr<Texture>> added;
+		added.swap(TS->added);
+
+		TS->lockAdded.clear();
+
+		for (const std::shared_ptr<Texture>& texture : added)
+			TS->push(texture);
+
+		size_t uploadedBytes = 0;
+
+		// At least one level per frame, so a level bigger than the budget still goes
+		while (!TS->queue.empty() && (uploadedBytes == 0 || uploadedBytes + TS->queue.front().nextLevelSize <= TS->frameBudget))
+		{
+			std::pop_heap(TS->queue.begin(), TS->queue.end(), isBigger);
+			Entry entry = TS->queue.back();
+			TS->queue.pop_back();
+
+			// Released by a scene change
+			std::shared_ptr<Texture> texture = entry.texture.lock();
+			if (!texture)
+				continue;
+
+			// Past the cap the textures keep the levels they have, but they always get their smallest one
+			if (texture->isDrawable && Texture::getTotalResidentSize() + entry.nextLevelSize > TS->residencyCap)
+			{
+				texture->freeLevels();
+				continue;
+			}
+
+			texture->streamNextLevel();
+
+			uploadedBytes += entry.nextLevelSize;
+
+			if (texture->streamedLevels > 0)
+				TS->push(texture);
+		}
+
+		TS->streamedBytes.fetch_add(uploadedBytes);
+	}
+
+	void TextureStreamer::setEnabled(bool isEnabled)
+	{
+		instance()->isEnabled = isEnabled;
+	}
+
+	bool TextureStreamer::isStreamingEnabled()
+	{
+		return instance()->isEnabled;
+	}
+
+	void TextureStreamer::setFrameBudget(size_t bytes)
+	{
+		instance()->frameBudget = bytes;
+	}
+
+	size_t TextureStreamer::getFrameBudget()
+	{
+		return instance()->frameBudget;
+	}
+
+	void TextureStreamer::setResidencyCap(size_t bytes)
+	{
+		instance()->residencyCap = bytes;
+	}
+
+	size_t TextureStreamer::getResidencyCap()
+	{
+		return instance()->residencyCap;
+	}
+
+	size_t TextureStreamer::getPendingCount()
+	{
+		return instance()->queue.size();
+	}
+
+	size_t TextureStreamer::getStreamedBytes()
+	{
+		return instance()->streamedBytes.load();
+	}
+}
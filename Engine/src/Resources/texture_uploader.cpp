@@ -0,0 +1,213 @@
+#include "texture_uploader.hpp"
+
+#include "debug.hpp"
+
+namespace Resources
+{
+	TextureUploader::~TextureUploader()
+	{
+		for (const Fence& fence : fences)
+			glDeleteSync(fence.sync);
+
+		// Unmapped with the buffer
+		if (bufferID)
+			glDeleteBuffers(1, &bufferID);
+	}
+
+	void TextureUploader::init()
+	{
+		TextureUploader* TU = instance();
+
+		if (TU->bufferID)
+			return;
+
+		if (!GLAD_GL_VERSION_4_4 && !GLAD_GL_ARB_buffer_storage)
+		{
+			Core::Debug::Log::warning("No persistent buffer mapping, the textures are uploaded from the client memory");
+			return;
+		}
+
+		// Written by the loading threads while the GPU reads the other slices, coherent so no flush is needed
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+		glGenBuffers(1, &TU->bufferID);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, TU->bufferID);
+		glBufferStorage(GL_PIXEL_UNPACK_BUFFER, TEXTURE_UPLOAD_RING_SIZE, nullptr, flags);
+
+		TU->mapping = (unsigned char*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, TEXTURE_UPLOAD_RING_SIZE, flags);
+
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+		if (!TU->mapping)
+		{
+			Core::Debug::Log::error("Unable to map the texture upload ring, the textures are uploaded from the client memory");
+			glDeleteBuffers(1, &TU->bufferID);
+			TU->bufferID = 0;
+		}
+	}
+
+	TextureUploader::Slice& TextureUploader::getSlice(uint64_t id)
+	{
+		return slices[(size_t)(id - firstSliceID)];
+	}
+
+	bool TextureUploader::reserve(size_t size, UploadSlice& slice)
+	{
+		TextureUploader* TU = instance();
+
+		size_t alignedSize = (size + TEXTURE_UPLOAD_ALIGNMENT - 1) / TEXTURE_UPLOAD_ALIGNMENT * TEXTURE_UPLOAD_ALIGNMENT;
+
+		if (!TU->mapping || alignedSize > TEXTURE_UPLOAD_RING_SIZE)
+		{
+			TU->fallbacksCount.fetch_add(1);
+			return false;
+		}
+
+		while (TU->lockSlices.test_and_set());
+
+		// A slice is never split, the end of the ring is skipped when it does not fit
+		uint64_t begin = TU->head;
+		size_t offset = (size_t)(begin % TEXTURE_UPLOAD_RING_SIZE);
+		if (offset + alignedSize > TEXTURE_UPLOAD_RING_SIZE)
+			begin += TEXTURE_UPLOAD_RING_SIZE - offset;
+
+		// Still read by the GPU, or reserved by other textures
+		if (begin + alignedSize - TU->tail > TEXTURE_UPLOAD_RING_SIZE)
+		{
+			TU->lockSlices.clear();
+			TU->fallbacksCount.fetch_add(1);
+			return false;
+		}
+
+		TU->head = begin + alignedSize;
+		TU->slices.push_back({ TU->head });
+
+		slice.id = TU->firstSliceID + TU->slices.size() - 1;
+
+		TU->lockSlices.clear();
+
+		slice.offset = (size_t)(begin % TEXTURE_UPLOAD_RING_SIZE);
+		slice.data = TU->mapping + slice.offset;
+
+		TU->uploadedBytes.fetch_add(size);
+
+		return true;
+	}
+
+	void TextureUploader::release(UploadSlice& slice)
+	{
+		if (!slice.isValid())
+			return;
+
+		TextureUploader* TU = instance();
+
+		while (TU->lockSlices.test_and_set());
+
+		TU->getSlice(slice.id).state = SliceState::RELEASED;
+
+		TU->lockSlices.clear();
+
+		slice = UploadSlice();
+	}
+
+	void TextureUploader::bind()
+	{
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, instance()->bufferID);
+	}
+
+	void TextureUploader::submit(UploadSlice& slice)
+	{
+		TextureUploader* TU = instance();
+
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+		while (TU->lockSlices.test_and_set());
+
+		Slice& submitted = TU->getSlice(slice.id);
+		submitted.state = SliceState::SUBMITTED;
+		submitted.frame = TU->frame;
+
+		TU->lockSlices.clear();
+
+		TU->hasSubmitted = true;
+		slice = UploadSlice();
+	}
+
+	void TextureUploader::recycle()
+	{
+		while (lockSlices.test_and_set());
+
+		while (!slices.empty())
+		{
+			const Slice& slice = slices.front();
+
+			if (slice.state == SliceState::RESERVED || (slice.state == SliceState::SUBMITTED && slice.frame >= completedFrame))
+				break;
+
+			tail = slice.end;
+			slices.pop_front();
+			firstSliceID++;
+		}
+
+		if (slices.empty())
+			tail = head;
+
+		lockSlices.clear();
+	}
+
+	void TextureUploader::update()
+	{
+		TextureUploader* TU = instance();
+
+		if (!TU->mapping)
+			return;
+
+		// One fence for all the copies of the frame
+		if (TU->hasSubmitted)
+		{
+			TU->fences.push_back({ glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), TU->frame });
+			TU->hasSubmitted = false;
+			TU->frame++;
+		}
+
+		// Never waits, the fences not signaled yet are checked again next frame
+		while (!TU->fences.empty())
+		{
+			const Fence& fence = TU->fences.front();
+
+			GLenum status = glClientWaitSync(fence.sync, 0, 0);
+			if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+				break;
+
+			TU->completedFrame = fence.frame + 1;
+
+			glDeleteSync(fence.sync);
+			TU->fences.pop_front();
+		}
+
+		TU->recycle();
+	}
+
+	size_t TextureUploader::getUploadedBytes()
+	{
+		return instance()->uploadedBytes.load();
+	}
+
+	size_t TextureUploader::getFallbacksCount()
+	{
+		return instance()->fallbacksCount.load();
+	}
+
+	size_t TextureUploader::getUsedBytes()
+	{
+		TextureUploader* TU = instance();
+
+		while (TU->lockSlices.test_and_set());
+
+		size_t usedBytes = (size_t)(TU->head - TU->tail);
+
+		TU->lockSlices.clear();
+
+		return usedBytes;
+	}
+}
@@ -0,0 +1,146 @@
+#include "vertex_layout.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+
+namespace Resources::Vertex
+{
+	unsigned int getSize(VertexLayout layout)
+	{
+		switch (layout)
+		{
+		case VertexLayout::STANDARD:
+			return 8 * sizeof(float);
+
+		case VertexLayout::PACKED_NORMALS:
+		case VertexLayout::OCTAHEDRAL_NORMALS:
+			return 3 * sizeof(float) + 2 * sizeof(uint16_t) + sizeof(uint32_t);
+		}
+
+		return 0;
+	}
+
+	const char* getLayoutName(VertexLayout layout)
+	{
+		switch (layout)
+		{
+		case VertexLayout::STANDARD:
+			return "Standard (32 B)";
+		case VertexLayout::PACKED_NORMALS:
+			return "Packed normals (20 B)";
+		case VertexLayout::OCTAHEDRAL_NORMALS:
+			return "Octahedral normals (20 B)";
+		}
+
+		return "";
+	}
+
+	static inline float clampUnit(float value)
+	{
+		return value < -1.f ? -1.f : (value > 1.f ? 1.f : value);
+	}
+
+	unsigned short floatToHalf(float value)
+	{
+		uint32_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+
+		uint32_t sign = (bits >> 16) & 0x8000;
+		int32_t exponent = (int32_t)((bits >> 23) & 0xFF) - 127 + 15;
+		uint32_t mantissa = bits & 0x7FFFFF;
+
+		// NaN and infinity
+		if (((bits >> 23) & 0xFF) == 0xFF)
+			return (unsigned short)(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+
+		// Overflow, clamp to infinity
+		if (exponent >= 31)
+			return (unsigned short)(sign | 0x7C00);
+
+		// Underflow, denormals or zero
+		if (exponent <= 0)
+		{
+			if (exponent < -10)
+				return (unsigned short)sign;
+
+			mantissa |= 0x800000;
+			uint32_t shift = 14 - exponent;
+			uint32_t half = mantissa >> shift;
+
+			// Round to nearest
+			if ((mantissa >> (shift - 1)) & 1)
+				half++;
+
+			return (unsigned short)(sign | half);
+		}
+
+		uint32_t half = sign | (exponent << 10) | (mantissa >> 13);
+
+		// Round to nearest, the carry can go up to the exponent
+		if (mantissa & 0x1000)
+			half++;
+
+		return (unsigned short)half;
+	}
+
+	unsigned int packNormal1010102(const Core::Maths::vec3& normal)
+	{
+		// Signed normalized components, w is left to 0
+		auto packComponent = [](float value) -> uint32_t
+		{
+			return (uint32_t)(int32_t)std::lround(clampUnit(value) * 511.f) & 0x3FF;
+		};
+
+		return packComponent(normal.x) | (packComponent(normal.y) << 10) | (packComponent(normal.z) << 20);
+	}
+
+	void packNormalOctahedral(const Core::Maths::vec3& normal, short* encoded)
+	{
+		float sum = fabsf(normal.x) + fabsf(normal.y) + fabsf(normal.z);
+		float x = sum > 0.f ? normal.x / sum : 0.f;
+		float y = sum > 0.f ? normal.y / sum : 0.f;
+
+		// Fold the lower hemisphere over the diagonals
+		if (normal.z < 0.f)
+		{
+			float foldedX = (1.f - fabsf(y)) * (x >= 0.f ? 1.f : -1.f);
+			float foldedY = (1.f - fabsf(x)) * (y >= 0.f ? 1.f : -1.f);
+			x = foldedX;
+			y = foldedY;
+		}
+
+		encoded[0] = (short)std::lround(clampUnit(x) * 32767.f);
+		encoded[1] = (short)std::lround(clampUnit(y) * 32767.f);
+	}
+
+	void pack(VertexLayout layout, unsigned char* vertex, const Core::Maths::vec3& position, const Core::Maths::vec3& texCoords, const Core::Maths::vec3& normal)
+	{
+		float floatPosition[3] = { position.x, position.y, position.z };
+		memcpy(vertex, floatPosition, sizeof(floatPosition));
+		vertex += sizeof(floatPosition);
+
+		if (layout == VertexLayout::STANDARD)
+		{
+			float floatAttributs[5] = { texCoords.x, texCoords.y, normal.x, normal.y, normal.z };
+			memcpy(vertex, floatAttributs, sizeof(floatAttributs));
+			return;
+		}
+
+		uint16_t halfTexCoords[2] = { floatToHalf(texCoords.x), floatToHalf(texCoords.y) };
+		memcpy(vertex, halfTexCoords, sizeof(halfTexCoords));
+		vertex += sizeof(halfTexCoords);
+
+		if (layout == VertexLayout::PACKED_NORMALS)
+		{
+			uint32_t packedNormal = packNormal1010102(normal);
+			memcpy(vertex, &packedNormal, sizeof(packedNormal));
+		}
+		else
+		{
+			short octahedralNormal[2];
+			packNormalOctahedral(normal, octahedralNormal);
+			memcpy(vertex, octahedralNormal, sizeof(octahedralNormal));
+		}
+	}
+}
@@ -0,0 +1,83 @@
+#include "allocations.hpp"
+
+#include <new>
+#include <atomic>
+#include <cstdlib>
+
+namespace Utils::Allocations
+{
+	static std::atomic<size_t> count{ 0 };
+
+	bool isCounted()
+	{
+#ifdef COUNT_ALLOCATIONS
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	size_t getCount()
+	{
+		return count.load(std::memory_order_relaxed);
+	}
+}
+
+#ifdef COUNT_ALLOCATIONS
+
+// Replace the global allocator to count its calls: new[] and nothrow use these ones by default
+void* operator new(size_t size)
+{
+	Utils::Allocations::count.fetch_add(1, std::memory_order_relaxed);
+
+	if (void* pointer = std::malloc(size > 0 ? size : 1))
+		return pointer;
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+	std::free(pointer);
+}
+
+// Over-aligned types
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	Utils::Allocations::count.fetch_add(1, std::memory_order_relaxed);
+
+	size_t align = (size_t)alignment;
+	size = size > 0 ? (size + align - 1) / align * align : align;
+
+#ifdef _WIN32
+	void* pointer = _aligned_malloc(size, align);
+#else
+	void* pointer = std::aligned_alloc(align, size);
+#endif
+
+	if (pointer)
+		return pointer;
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+#ifdef _WIN32
+	_aligned_free(pointer);
+#else
+	std::free(pointer);
+#endif
+}
+
+void operator delete(void* pointer, size_t, std::align_val_t alignment) noexcept
+{
+	operator delete(pointer, alignment);
+}
+
+#endif
@@ -0,0 +1,96 @@
+#include "hash.hpp"
+
+#include <cstring>
+
+namespace Utils
+{
+	#pragma region ____HASH____
+
+	static const uint64_t PRIME1 = 11400714785074694791ull;
+	static const uint64_t PRIME2 = 14029467366897019727ull;
+	static const uint64_t PRIME3 = 1609587929392839161ull;
+	static const uint64_t PRIME4 = 9650029242287828579ull;
+	static const uint64_t PRIME5 = 2870177450012600261ull;
+
+	static inline uint64_t rotateLeft(uint64_t value, int bits)
+	{
+		return (value << bits) | (value >> (64 - bits));
+	}
+
+	static inline uint64_t read64(const unsigned char* data)
+	{
+		uint64_t value;
+		memcpy(&value, data, sizeof(value));
+		return value;
+	}
+
+	static inline uint32_t read32(const unsigned char* data)
+	{
+		uint32_t value;
+		memcpy(&value, data, sizeof(value));
+		return value;
+	}
+
+	static inline uint64_t hashRound(uint64_t acc, uint64_t input)
+	{
+		acc += input * PRIME2;
+		return rotateLeft(acc, 31) * PRIME1;
+	}
+
+	static inline uint64_t hashMerge(uint64_t acc, uint64_t value)
+	{
+		acc ^= hashRound(0, value);
+		return acc * PRIME1 + PRIME4;
+	}
+
+	#pragma endregion
+
+	uint64_t hashBytes(const void* data, size_t size, uint64_t seed)
+	{
+		const unsigned char* cur = (const unsigned char*)data;
+		const unsigned char* end = cur + size;
+
+		uint64_t hash;
+
+		// 4 independent lanes of 8 bytes
+		if (size >= 32)
+		{
+			uint64_t lanes[4] = { seed + PRIME1 + PRIME2, seed + PRIME2, seed, seed - PRIME1 };
+
+			for (; cur + 32 <= end; cur += 32)
+			{
+				for (int i = 0; i < 4; i++)
+					lanes[i] = hashRound(lanes[i], read64(cur + i * 8));
+			}
+
+			hash = rotateLeft(lanes[0], 1) + rotateLeft(lanes[1], 7) + rotateLeft(lanes[2], 12) + rotateLeft(lanes[3], 18);
+
+			for (int i = 0; i < 4; i++)
+				hash = hashMerge(hash, lanes[i]);
+		}
+		else
+			hash = seed + PRIME5;
+
+		hash += size;
+
+		for (; cur + 8 <= end; cur += 8)
+			hash = rotateLeft(hash ^ hashRound(0, read64(cur)), 27) * PRIME1 + PRIME4;
+
+		if (cur + 4 <= end)
+		{
+			hash = rotateLeft(hash ^ (read32(cur) * PRIME1), 23) * PRIME2 + PRIME3;
+			cur += 4;
+		}
+
+		for (; cur < end; cur++)
+			hash = rotateLeft(hash ^ (*cur * PRIME5), 11) * PRIME1;
+
+		hash ^= hash >> 33;
+		hash *= PRIME2;
+		hash ^= hash >> 29;
+		hash *= PRIME3;
+		hash ^= hash >> 32;
+
+		return hash;
+	}
+}
@@ -0,0 +1,239 @@
+#include "image_pool.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+// 256 B to 256 MB, 4 classes per power of two
+#define IMAGE_POOL_CLASSES_COUNT 81
+#define IMAGE_POOL_LARGE_BLOCK ((size_t)-1)
+
+namespace Utils::ImagePool
+{
+	// In front of each block, keeps the payload 16 bytes aligned
+	struct alignas(16) Header
+	{
+		size_t classIndex = 0;
+		size_t size = 0;		// Requested size of the large blocks
+	};
+
+	// Free blocks of each class, linked through their payload
+	struct FreeLists
+	{
+		Header* lists[IMAGE_POOL_CLASSES_COUNT] = {};
+		size_t bytes = 0;
+	};
+
+	static FreeLists shared;
+	static std::atomic_flag lockShared = ATOMIC_FLAG_INIT;
+
+	static std::atomic<size_t> liveBytes{ 0 };
+	static std::atomic<size_t> peakBytes{ 0 };
+	static std::atomic<size_t> pooledBytes{ 0 };
+	static std::atomic<size_t> allocationsCount{ 0 };
+	static std::atomic<size_t> reusedCount{ 0 };
+
+	#pragma region ____CLASSES____
+
+	static size_t getClassSize(size_t classIndex)
+	{
+		if (classIndex == 0)
+			return IMAGE_POOL_MIN_BLOCK;
+
+		size_t power = (classIndex - 1) / 4 + 8;
+		size_t step = (classIndex - 1) % 4 + 1;
+
+		return ((size_t)1 << power) + step * ((size_t)1 << (power - 2));
+	}
+
+	static size_t getClassIndex(size_t size)
+	{
+		if (size <= IMAGE_POOL_MIN_BLOCK)
+			return 0;
+
+		// Size in ]2^power, 2^(power + 1)]
+		size_t power = 8;
+		while (((size - 1) >> (power + 1)) != 0)
+			power++;
+
+		size_t quarter = (size_t)1 << (power - 2);
+		size_t step = (size - ((size_t)1 << power) + quarter - 1) / quarter;
+
+		return (power - 8) * 4 + step;
+	}
+
+	static inline Header*& getNext(Header* block)
+	{
+		return *(Header**)(block + 1);
+	}
+
+	#pragma endregion
+
+	#pragma region ____LISTS____
+
+	static void pushShared(Header* block, size_t blockSize)
+	{
+		while (lockShared.test_and_set());
+
+		if (shared.bytes + blockSize <= IMAGE_POOL_SHARED_BYTES)
+		{
+			getNext(block) = shared.lists[block->classIndex];
+			shared.lists[block->classIndex] = block;
+			shared.bytes += blockSize;
+			block = nullptr;
+		}
+
+		lockShared.clear();
+
+		// No room left, back to the system
+		if (block)
+		{
+			pooledBytes.fetch_sub(blockSize);
+			std::free(block);
+		}
+	}
+
+	static Header* popShared(size_t classIndex)
+	{
+		while (lockShared.test_and_set());
+
+		Header* block = shared.lists[classIndex];
+		if (block)
+		{
+			shared.lists[classIndex] = getNext(block);
+			shared.bytes -= getClassSize(classIndex);
+		}
+
+		lockShared.clear();
+
+		return block;
+	}
+
+	// Cache of the current thread, handed to the shared lists when the thread ends
+	struct ThreadCache : FreeLists
+	{
+		~ThreadCache()
+		{
+			for (size_t i = 0; i < IMAGE_POOL_CLASSES_COUNT; i++)
+			{
+				while (Header* block = lists[i])
+				{
+					lists[i] = getNext(block);
+					pushShared(block, getClassSize(i));
+				}
+			}
+		}
+	};
+
+	static thread_local ThreadCache cache;
+
+	#pragma endregion
+
+	void* allocate(size_t size)
+	{
+		allocationsCount.fetch_add(1);
+
+		size_t classIndex = size > IMAGE_POOL_MAX_BLOCK ? IMAGE_POOL_LARGE_BLOCK : getClassIndex(size);
+		size_t blockSize = classIndex == IMAGE_POOL_LARGE_BLOCK ? size : getClassSize(classIndex);
+
+		Header* block = nullptr;
+
+		if (classIndex != IMAGE_POOL_LARGE_BLOCK)
+		{
+			// Thread cache first, no lock
+			block = cache.lists[classIndex];
+			if (block)
+			{
+				cache.lists[classIndex] = getNext(block);
+				cache.bytes -= blockSize;
+			}
+			else
+				block = popShared(classIndex);
+		}
+
+		if (block)
+		{
+			reusedCount.fetch_add(1);
+			pooledBytes.fetch_sub(blockSize);
+		}
+		else
+		{
+			block = (Header*)std::malloc(sizeof(Header) + blockSize);
+			if (!block)
+				return nullptr;
+		}
+
+		block->classIndex = classIndex;
+		block->size = size;
+
+		size_t live = liveBytes.fetch_add(blockSize) + blockSize;
+		size_t peak = peakBytes.load();
+		while (live > peak && !peakBytes.compare_exchange_weak(peak, live));
+
+		return block + 1;
+	}
+
+	void* reallocate(void* pointer, size_t size)
+	{
+		if (!pointer)
+			return allocate(size);
+
+		Header* block = (Header*)pointer - 1;
+		size_t capacity = block->classIndex == IMAGE_POOL_LARGE_BLOCK ? block->size : getClassSize(block->classIndex);
+
+		// stb grows its buffers by doubling, most of the steps stay in the class
+		if (size <= capacity)
+			return pointer;
+
+		void* newPointer = allocate(size);
+		if (!newPointer)
+			return nullptr;
+
+		memcpy(newPointer, pointer, std::min(capacity, size));
+		free(pointer);
+
+		return newPointer;
+	}
+
+	void free(void* pointer)
+	{
+		if (!pointer)
+			return;
+
+		Header* block = (Header*)pointer - 1;
+
+		if (block->classIndex == IMAGE_POOL_LARGE_BLOCK)
+		{
+			liveBytes.fetch_sub(block->size);
+			std::free(block);
+			return;
+		}
+
+		size_t blockSize = getClassSize(block->classIndex);
+
+		liveBytes.fetch_sub(blockSize);
+		pooledBytes.fetch_add(blockSize);
+
+		if (cache.bytes + blockSize <= IMAGE_POOL_THREAD_BYTES)
+		{
+			getNext(block) = cache.lists[block->classIndex];
+			cache.lists[block->classIndex] = block;
+			cache.bytes += blockSize;
+		}
+		else
+			pushShared(block, blockSize);
+	}
+
+	Stats getStats()
+	{
+		Stats stats;
+		stats.liveBytes = liveBytes.load();
+		stats.peakBytes = peakBytes.load();
+		stats.pooledBytes = pooledBytes.load();
+		stats.allocationsCount = allocationsCount.load();
+		stats.reusedCount = reusedCount.load();
+
+		return stats;
+	}
+}
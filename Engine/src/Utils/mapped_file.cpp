@@ -0,0 +1,155 @@
+#include "mapped_file.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Utils
+{
+	MappedFile::MappedFile(const std::string& filePath)
+	{
+		open(filePath);
+	}
+
+	MappedFile::~MappedFile()
+	{
+		close();
+	}
+
+#ifdef _WIN32
+	bool MappedFile::open(const std::string& filePath)
+	{
+		close();
+
+		HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(file, &fileSize))
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		m_file = file;
+		m_size = (size_t)fileSize.QuadPart;
+
+		// An empty file can not be mapped, keep a valid empty view
+		if (m_size == 0)
+			return true;
+
+		m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!m_mapping)
+		{
+			close();
+			return false;
+		}
+
+		m_data = (const char*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+		if (!m_data)
+		{
+			close();
+			return false;
+		}
+
+		return true;
+	}
+
+	void MappedFile::close()
+	{
+		if (m_data)
+			UnmapViewOfFile(m_data);
+		if (m_mapping)
+			CloseHandle(m_mapping);
+		if (m_file)
+			CloseHandle(m_file);
+
+		m_data = nullptr;
+		m_mapping = nullptr;
+		m_file = nullptr;
+		m_size = 0;
+	}
+
+	bool MappedFile::isOpen() const
+	{
+		return m_file != nullptr;
+	}
+#else
+	bool MappedFile::open(const std::string& filePath)
+	{
+		close();
+
+		int file = ::open(filePath.c_str(), O_RDONLY);
+		if (file < 0)
+			return false;
+
+		struct stat fileStat;
+		if (fstat(file, &fileStat) != 0)
+		{
+			::close(file);
+			return false;
+		}
+
+		m_file = file;
+		m_size = (size_t)fileStat.st_size;
+
+		// An empty file can not be mapped, keep a valid empty view
+		if (m_size == 0)
+			return true;
+
+		void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+		if (data == MAP_FAILED)
+		{
+			close();
+			return false;
+		}
+
+		madvise(data, m_size, MADV_SEQUENTIAL);
+		m_data = (const char*)data;
+
+		return true;
+	}
+
+	void MappedFile::close()
+	{
+		if (m_data)
+			munmap((void*)m_data, m_size);
+		if (m_file >= 0)
+			::close(m_file);
+
+		m_data = nullptr;
+		m_file = -1;
+		m_size = 0;
+	}
+
+	bool MappedFile::isOpen() const
+	{
+		return m_file >= 0;
+	}
+#endif
+
+	const char* MappedFile::data() const
+	{
+		return m_data;
+	}
+
+	const char* MappedFile::end() const
+	{
+		return m_data + m_size;
+	}
+
+	size_t MappedFile::size() const
+	{
+		return m_size;
+	}
+}
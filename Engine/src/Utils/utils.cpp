@@ -1,9 +1,20 @@
 #include "utils.hpp"
 
 #include <imgui.h>
+#include <cstring>
 #include <iostream>
 #include <algorithm>
 
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi")
+#else
+#include <sys/resource.h>
+#endif
+
 namespace Utils
 {
     bool hasPrefix(const std::string& str, const std::string& prefix)
@@ -189,4 +200,22 @@ namespace Utils
 
         return std::to_string(min) + " min and " + std::to_string(seconds) + " secs";
     }
-}
\ No newline at end of file
+
+    size_t getPeakMemoryUsage()
+    {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+            return counters.PeakWorkingSetSize;
+
+        return 0;
+#else
+        // ru_maxrss is in kilobytes
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0)
+            return (size_t)usage.ru_maxrss * 1024;
+
+        return 0;
+#endif
+    }
+}